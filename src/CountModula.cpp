@@ -4,6 +4,8 @@
 //----------------------------------------------------------------------------
 
 #include "CountModula.hpp"
+#include <mutex>
+#include <map>
 
 Plugin *pluginInstance;
 int defaultTheme = 0;
@@ -13,6 +15,9 @@ int prevDefaultTheme = -1;
 void init(Plugin *p) {
 	pluginInstance = p;
 
+	// load the global settings once - everything else works from the in-memory copy
+	loadSettings();
+	
 	defaultTheme = readDefaultIntegerValue("DefaultTheme");
 	prevDefaultTheme = -1;
 	
@@ -31,68 +36,166 @@ int getDefaultTheme(bool previous) {
 }
 
 
-// save the given global count modula settings`
-void saveSettings(json_t *rootJ) {
-	std::string settingsFilename = asset::user("CountModula.json");
+// in-memory copy of the global count modula settings file.
+// the file is read once at startup and only written when a setting actually changes.
+// changes only come from menu actions so the write happens there and then on the UI thread
+struct SettingsCache {
+	json_t *rootJ = NULL;
+	bool dirty = false;
+	std::mutex mutex;
+	
+	~SettingsCache() {
+		// no file access here - everything has already been written by the time we're unloaded
+		if (rootJ)
+			json_decref(rootJ);
+	}
+
+	// write the settings file if there are unsaved changes
+	void flush() {
+		json_t *data = NULL;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (dirty && rootJ) {
+				data = json_deep_copy(rootJ);
+				dirty = false;
+			}
+		}
+
+		if (!data)
+			return;
+
+		std::string settingsFilename = asset::user("CountModula.json");
+		FILE *file = fopen(settingsFilename.c_str(), "w");
+		
+		if (file) {
+			json_dumpf(data, file, JSON_INDENT(2) | JSON_REAL_PRECISION(9));
+			fclose(file);
+		}
+
+		json_decref(data);
+	}
+};
+
+static SettingsCache settingsCache;
+
+// read the global count modula settings file into the cache
+void loadSettings() {
+	json_t *rootJ = NULL;
 	
-	FILE *file = fopen(settingsFilename.c_str(), "w");
+	std::string settingsFilename = asset::user("CountModula.json");
+	FILE *file = fopen(settingsFilename.c_str(), "r");
 	
 	if (file) {
-		json_dumpf(rootJ, file, JSON_INDENT(2) | JSON_REAL_PRECISION(9));
+		json_error_t error;
+		rootJ = json_loadf(file, 0, &error);
 		fclose(file);
 	}
+	
+	if (!rootJ)
+		rootJ = json_object();
+	
+	std::lock_guard<std::mutex> lock(settingsCache.mutex);
+	if (settingsCache.rootJ)
+		json_decref(settingsCache.rootJ);
+		
+	settingsCache.rootJ = rootJ;
+	settingsCache.dirty = false;
 }
 
-// read the global count modula settings
-json_t * readSettings() {
-	std::string settingsFilename = asset::user("CountModula.json");
-	FILE *file = fopen(settingsFilename.c_str(), "r");
+// save the given global count modula settings`
+void saveSettings(json_t *rootJ) {
+	json_t *data = json_deep_copy(rootJ);
 	
-	if (!file) {
-		return json_object();
+	{
+		std::lock_guard<std::mutex> lock(settingsCache.mutex);
+		if (settingsCache.rootJ)
+			json_decref(settingsCache.rootJ);
+		
+		settingsCache.rootJ = data;
+		settingsCache.dirty = true;
 	}
 	
-	json_error_t error;
-	json_t *rootJ = json_loadf(file, 0, &error);
+	settingsCache.flush();
+}
+
+// read the global count modula settings - the caller owns the returned copy
+json_t * readSettings() {
+	std::lock_guard<std::mutex> lock(settingsCache.mutex);
 	
-	fclose(file);
-	return rootJ;
+	if (!settingsCache.rootJ)
+		return json_object();
+	
+	return json_deep_copy(settingsCache.rootJ);
 }
 
 // read the given default integer value from the global count modula settings file
 int readDefaultIntegerValue(std::string setting) {
 	int value = 0; // default to the standard value
 	
-	// read the settings file
-	json_t *rootJ = readSettings();
+	// read straight from the cached settings - no need to take a copy for a single value
+	std::lock_guard<std::mutex> lock(settingsCache.mutex);
 	
 	// get the default value
-	json_t* jsonValue = json_object_get(rootJ, setting.c_str());
+	json_t* jsonValue = settingsCache.rootJ ? json_object_get(settingsCache.rootJ, setting.c_str()) : NULL;
 	if (jsonValue)
 		value = json_integer_value(jsonValue);
 
-	// houskeeping
-	json_decref(rootJ);
-	
 	return value;
 }
 
 // save the given integer value in the global count modula settings file
 void saveDefaultIntegerValue(std::string setting, int value) {
-	// read the settings file
-	json_t *rootJ = readSettings();
-	
-	// set the default theme value
-	json_object_set_new(rootJ, setting.c_str(), json_integer(value));
-
-	// save the updated data
-	saveSettings(rootJ);
+	{
+		std::lock_guard<std::mutex> lock(settingsCache.mutex);
+		
+		if (!settingsCache.rootJ)
+			settingsCache.rootJ = json_object();
+		
+		// nothing to do if the value hasn't changed
+		json_t* jsonValue = json_object_get(settingsCache.rootJ, setting.c_str());
+		if (jsonValue && json_integer_value(jsonValue) == value)
+			return;
+		
+		// set the default value
+		json_object_set_new(settingsCache.rootJ, setting.c_str(), json_integer(value));
+		settingsCache.dirty = true;
+	}
 	
-	// houskeeping
-	json_decref(rootJ);
+	settingsCache.flush();
 }
 
 
+// theme panel registry - resource sub-directory for each theme number
+static const std::string themeDirectories[] = {
+	"",				// Silver
+	"Moonlight/",
+	"Absinthe/",
+	"Raven/",
+	"Sanguine/",
+	"BlueMoon/",
+	"TrickOrTreat/"
+};
+
+// panels loaded so far, keyed on theme and panel file name. only ever touched from the UI thread
+static std::map<std::pair<int, std::string>, std::shared_ptr<Svg>> themedPanels;
+
+// get the panel svg for the given theme, loading it the first time it is asked for
+std::shared_ptr<Svg> getThemedPanel(int theme, const std::string &panelName) {
+	// anything we don't know about gets the standard theme
+	if (theme < 0 || theme >= (int)(sizeof(themeDirectories) / sizeof(themeDirectories[0])))
+		theme = 0;
+
+	std::pair<int, std::string> key(theme, panelName);
+	
+	auto it = themedPanels.find(key);
+	if (it != themedPanels.end())
+		return it->second;
+	
+	std::shared_ptr<Svg> svg = APP->window->loadSvg(asset::plugin(pluginInstance, "res/" + themeDirectories[theme] + panelName));
+	themedPanels[key] = svg;
+	
+	return svg;
+}
 
 // hack for module expanders always to the right
 static math::Vec eachNearestGridPosRight(math::Vec pos, std::function<bool(math::Vec pos)> f) {
@@ -11,7 +11,8 @@ extern Plugin *pluginInstance;
 // Forward-declare each Model, defined in each module source file
 #include "DeclareModels.hpp"
 
-// settings file 
+// settings file - read once at startup and cached, written straight away when a setting changes
+void loadSettings();
 json_t * readSettings();
 void saveSettings(json_t *rootJ);
 
@@ -23,6 +24,9 @@ void saveDefaultIntegerValue(std::string setting, int value);
 void setDefaultTheme(int themeToUse, bool previous);
 int getDefaultTheme(bool previous);
 
+// theme panel registry
+std::shared_ptr<Svg> getThemedPanel(int theme, const std::string &panelName);
+
 
 // hack for module expanders always to the right or left
 void setModulePosNearestRight(ModuleWidget* mw, math::Vec pos);
@@ -3,6 +3,7 @@
 //	For passing sequence details to and from sequencer expander modules
 //  Copyright (C) 2019  Adam Verspaget
 //----------------------------------------------------------------------------
+#include "ExpanderTopology.hpp"
 
 #define CRG_EXP_NUM_CHANNELS 8
 
@@ -10,6 +11,15 @@
 #define isExpanderModule(x) x->model == modelClockedRandomGateExpanderCV || x->model == modelClockedRandomGateExpanderLog
 #define isExpandableModule(x) x->model == modelClockedRandomGates
 
+// expander topology tests
+inline bool isClockedRandomGateExpander(Module *m) {
+	return isExpanderModule(m);
+}
+
+inline bool isClockedRandomGateChainModule(Module *m) {
+	return isExpanderModule(m) || isExpandableModule(m);
+}
+
 struct ClockedRandomGateExpanderMessage {
 	
 	bool singleMode;
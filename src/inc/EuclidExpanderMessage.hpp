@@ -3,6 +3,7 @@
 //	For passing sequence details to and from euclidean sequencer expander modules
 //  Copyright (C) 2020  Adam Verspaget
 //----------------------------------------------------------------------------
+#include "ExpanderTopology.hpp"
 
 #define EUCLID_EXP_NUM_STEPS 8
 
@@ -10,6 +11,15 @@
 #define isExpanderModule(x) x->model == modelEuclidExpanderCV
 #define isExpandableModule(x) x->model == modelEuclid
 
+// expander topology tests
+inline bool isEuclidExpander(Module *m) {
+	return isExpanderModule(m);
+}
+
+inline bool isEuclidChainModule(Module *m) {
+	return isExpanderModule(m) || isExpandableModule(m);
+}
+
 struct EuclidExpanderMessage {
 	bool beatGate;
 	bool restGate;
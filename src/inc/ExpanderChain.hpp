@@ -0,0 +1,136 @@
+//----------------------------------------------------------------------------
+//	/^M^\ Count Modula Plugin for VCV Rack - Expander chain
+//	Zero latency expander chaining. The master resolves the chain of expanders
+//	to its right whenever the rack layout changes and then drives each one
+//	directly from its own process() call, passing a single shared message
+//	along the chain rather than double buffering it one module at a time.
+//  Copyright (C) 2023  Adam Verspaget
+//----------------------------------------------------------------------------
+#pragma once
+#include <vector>
+#include <atomic>
+
+// the longest chain we'll bother following
+#define EXPANDER_CHAIN_MAX_LENGTH 64
+
+// incremented by every chain member whenever one of its neighbours changes so
+// that the chains only have to be resolved again when something has actually moved
+inline std::atomic<unsigned int> &expanderChainGeneration() {
+	static std::atomic<unsigned int> generation(0);
+	return generation;
+}
+
+// family membership tests - set by each module for its own family of expanders
+typedef bool (*ExpanderChainTest)(Module *);
+
+template <typename MESSAGE>
+struct ChainedExpander : Module {
+	ExpanderChainTest isChainExpander = NULL;
+	ExpanderChainTest isChainMaster = NULL;
+
+	// set when a master to the left is driving this expander
+	bool chained = false;
+	unsigned int chainGeneration = ~0u;
+	Module *chainedLeft = NULL;
+
+	// process the expander with the given message or NULL if there is no master.
+	// when chained, the message is updated in place ready for the next expander along.
+	virtual void processExpander(const ProcessArgs &args, MESSAGE *message) = 0;
+
+	// whether this expander accepts the chain from the given left hand module - by default any member of the family
+	virtual bool chainsFrom(Module *left) {
+		return isChainMaster(left) || isChainExpander(left);
+	}
+
+	// determine if there is a master somewhere to the left of us. each step uses that
+	// expander's own view of its neighbour so we always agree with the master's view
+	bool findMaster() {
+		ChainedExpander<MESSAGE> *current = this;
+
+		for (int i = 0; i < EXPANDER_CHAIN_MAX_LENGTH; i++) {
+			Module *left = current->leftExpander.module;
+			if (!left || !current->chainsFrom(left))
+				return false;
+
+			if (current->isChainMaster(left))
+				return true;
+
+			current = (ChainedExpander<MESSAGE> *)left;
+		}
+
+		return false;
+	}
+
+	void process(const ProcessArgs &args) override {
+		// a change on our left that nobody told us about means everyone needs to take another look
+		if (leftExpander.module != chainedLeft) {
+			chainedLeft = leftExpander.module;
+			expanderChainGeneration()++;
+		}
+
+		if (chainGeneration != expanderChainGeneration()) {
+			chained = findMaster();
+			chainGeneration = expanderChainGeneration();
+		}
+
+		// the master takes care of us when we're part of a chain
+		if (!chained)
+			processExpander(args, NULL);
+	}
+
+	void onExpanderChange(const ExpanderChangeEvent &e) override {
+		expanderChainGeneration()++;
+	}
+};
+
+template <typename MESSAGE>
+struct ExpanderChain {
+	std::vector<ChainedExpander<MESSAGE> *> expanders;
+	Module *master = NULL;
+	unsigned int generation = ~0u;
+
+	// the shared message passed along the chain
+	MESSAGE message;
+
+	// resolve the chain of expanders to the right of the given master if the layout has changed.
+	// returns true if there is anything to drive
+	bool resolve(Module *master, ExpanderChainTest isChainExpander) {
+		if (generation != expanderChainGeneration()) {
+			generation = expanderChainGeneration();
+			expanders.clear();
+			this->master = master;
+
+			Module *left = master;
+			Module *right = master->rightExpander.module;
+
+			while (right && isChainExpander(right) && expanders.size() < EXPANDER_CHAIN_MAX_LENGTH) {
+				ChainedExpander<MESSAGE> *expander = (ChainedExpander<MESSAGE> *)right;
+				if (!expander->chainsFrom(left))
+					break;
+
+				expanders.push_back(expander);
+				left = right;
+				right = right->rightExpander.module;
+			}
+		}
+
+		return !expanders.empty();
+	}
+
+	// drive each expander in turn with the current message. bypassed expanders are skipped.
+	// the links are checked as we go so we never touch a module that has been removed
+	void process(const Module::ProcessArgs &args) {
+		Module *left = master;
+		for (ChainedExpander<MESSAGE> *expander : expanders) {
+			if (left->rightExpander.module != expander) {
+				expanderChainGeneration()++;
+				break;
+			}
+
+			if (!expander->isBypassed())
+				expander->processExpander(args, &message);
+
+			left = expander;
+		}
+	}
+};
@@ -0,0 +1,48 @@
+//----------------------------------------------------------------------------
+//	/^M^\ Count Modula Plugin for VCV Rack - Expander topology
+//	Caches the neighbouring modules that belong to a module's expander family.
+//	The family tests are only run when the layout changes so the per-sample
+//	check is simply whether or not we have a neighbour.
+//  Copyright (C) 2023  Adam Verspaget
+//----------------------------------------------------------------------------
+#pragma once
+
+// expander family membership test
+typedef bool (*ExpanderModuleTest)(Module *);
+
+struct ExpanderTopology {
+	Module *module = NULL;
+	ExpanderModuleTest isLeftModule = NULL;
+	ExpanderModuleTest isRightModule = NULL;
+
+	// neighbours that belong to the family, NULL otherwise
+	Module *leftModule = NULL;
+	Module *rightModule = NULL;
+
+	// set the owning module and the tests used for each side - NULL if we don't talk to that side
+	void config(Module *owner, ExpanderModuleTest leftTest, ExpanderModuleTest rightTest) {
+		module = owner;
+		isLeftModule = leftTest;
+		isRightModule = rightTest;
+
+		update();
+	}
+
+	// work out the neighbours again - call from the module's onExpanderChange()
+	void update() {
+		Module *l = module->leftExpander.module;
+		Module *r = module->rightExpander.module;
+
+		leftModule = (l && isLeftModule && isLeftModule(l)) ? l : NULL;
+		rightModule = (r && isRightModule && isRightModule(r)) ? r : NULL;
+	}
+
+	// the cached neighbours - one that has gone away since the last update is never returned
+	Module *left() {
+		return module->leftExpander.module == leftModule ? leftModule : NULL;
+	}
+
+	Module *right() {
+		return module->rightExpander.module == rightModule ? rightModule : NULL;
+	}
+};
@@ -3,6 +3,16 @@
 //	For passing fade details to and from the fade and fade expander modules
 //  Copyright (C) 2019  Adam Verspaget
 //----------------------------------------------------------------------------
+#include "ExpanderTopology.hpp"
+
+// expander topology tests
+inline bool isFadeExpander(Module *m) {
+	return m->model == modelFadeExpander;
+}
+
+inline bool isFade(Module *m) {
+	return m->model == modelFade;
+}
 
 struct FadeExpanderMessage {
 	float envelope = 0.0f;
@@ -0,0 +1,129 @@
+//------------------------------------------------------------------------
+//  /^M^\ Count Modula Plugin for VCV Rack - Frequency Divider Bank
+//	Structure of arrays version of the FrequencyDivider processing 4 dividers
+//	at a time. Each lane behaves exactly as a single FrequencyDivider would.
+//  Copyright (C) 2023  Adam Verspaget
+//----------------------------------------------------------------------------
+#pragma once
+#include "FrequencyDivider.hpp"
+#include "GateProcessorSimd.hpp"
+
+using simd::float_4;
+using simd::int32_4;
+
+template <int SIZE>
+struct FrequencyDividerBank {
+	static const int NUM_GROUPS = (SIZE + 3) / 4;
+
+	int32_4 count[NUM_GROUPS];
+	int32_4 N[NUM_GROUPS];
+	int32_4 countUp[NUM_GROUPS];	// lane mask - set for COUNT_UP, clear for COUNT_DN
+	float_4 phase[NUM_GROUPS];		// lane mask - set when the divider output is high
+	int maxN = 20;
+
+	GateProcessorSimd gates[NUM_GROUPS];
+
+	FrequencyDividerBank() {
+		for (int g = 0; g < NUM_GROUPS; g++) {
+			count[g] = int32_4::zero();
+			N[g] = int32_4::zero();
+			countUp[g] = int32_4::zero();
+			phase[g] = float_4::zero();
+		}
+	}
+
+	// process the given clock values for the given group of 4 dividers and return the current divider states
+	float_4 process(int g, float_4 clk) {
+		gates[g].set(clk);
+
+		return clock(g, gates[g].anyEdge());
+	}
+
+	// advance the given group of 4 dividers on the lanes set in the given edge mask
+	// allows a number of banks to share the one set of clock gate processors
+	float_4 clock(int g, float_4 edges) {
+		int32_4 edge = int32_4::cast(edges);
+
+		// edge lanes are all ones (-1) so subtracting the mask increments only those counters
+		int32_4 c = count[g] - edge;
+
+		// for count up mode, flip the phase at the end of the count
+		int32_4 flip = edge & countUp[g] & (c == N[g]);
+
+		// we've hit the counter
+		c = c & ~(edge & ~(c < N[g]));
+
+		// for count down mode, flip the phase at the start of the count
+		flip = flip | (edge & ~countUp[g] & (c == int32_4::zero()));
+
+		count[g] = c;
+		phase[g] = phase[g] ^ float_4::cast(flip);
+
+		return phase[g];
+	}
+
+	// current output state of the given divider
+	bool state(int i) {
+		return simd::movemask(phase[i >> 2]) & (1 << (i & 3));
+	}
+
+	// set the division value of the given divider
+	void setN(int i, int in) {
+		N[i >> 2][i & 3] = clamp(in, 1, maxN);
+	}
+
+	// set the division value of all dividers
+	void setN(int in) {
+		int32_4 n = int32_4(clamp(in, 1, maxN));
+		for (int g = 0; g < NUM_GROUPS; g++)
+			N[g] = n;
+	}
+
+	// get the division value of the given divider
+	int getN(int i) {
+		return N[i >> 2][i & 3];
+	}
+
+	// set the counter mode of the given divider to up or down
+	void setCountMode(int i, int mode) {
+		switch(mode) {
+			case COUNT_DN:
+			case COUNT_UP:
+				countUp[i >> 2][i & 3] = (mode == COUNT_UP ? -1 : 0);
+				break;
+		}
+	}
+
+	// get the counter mode of the given divider
+	int getCountMode(int i) {
+		return countUp[i >> 2][i & 3] ? COUNT_UP : COUNT_DN;
+	}
+
+	// set the maximum division value - limited to 1-64 in line with the FrequencyDivider
+	void setMaxN(int max) {
+		maxN = clamp(max, 1, 64);
+	}
+
+	// reset the given divider
+	void reset(int i) {
+		int g = i >> 2;
+		int l = i & 3;
+
+		count[g][l] = -1;
+		N[g][l] = 0;
+		countUp[g][l] = 0;
+		phase[g][l] = 0.0f;
+		gates[g].reset(l);
+	}
+
+	// reset all dividers and their clock inputs
+	void reset() {
+		for (int g = 0; g < NUM_GROUPS; g++) {
+			count[g] = int32_4(-1);
+			N[g] = int32_4::zero();
+			countUp[g] = int32_4::zero();
+			phase[g] = float_4::zero();
+			gates[g].reset();
+		}
+	}
+};
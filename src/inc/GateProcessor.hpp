@@ -9,6 +9,8 @@ class GateProcessor {
 		dsp::SchmittTrigger st;
 		bool prevState = false;
 		bool currentState = false;
+		float prevValue = 0.0f;
+		float currentValue = 0.0f;
 		
 	public:
 		// set the gate with the given value
@@ -19,6 +21,9 @@ class GateProcessor {
 			prevState = currentState;
 			currentState = st.isHigh();
 			
+			prevValue = currentValue;
+			currentValue = value;
+			
 			return currentState;
 		}
 		
@@ -26,6 +31,7 @@ class GateProcessor {
 		void reset() {
 			st.reset();
 			prevState = currentState = false;		
+			prevValue = currentValue = 0.0f;
 		}
 		
 		// preset the gate processor
@@ -68,6 +74,16 @@ class GateProcessor {
 			return prevState != currentState;
 		}
 		
+		// sub-sample estimate of how long ago the latest edge crossed its threshold as a fraction of a sample.
+		// linearly interpolated between the last two values, 0 if there was no edge
+		float edgeDelay() {
+			if (prevState == currentState || currentValue == prevValue)
+				return 0.0f;
+			
+			float threshold = currentState ? 2.0f : 0.1f;
+			return clamp((currentValue - threshold) / (currentValue - prevValue), 0.0f, 1.0f);
+		}
+		
 		// gate state value for output
 		float value() {
 			return currentState ? 10.0f : 0.0f;
@@ -0,0 +1,87 @@
+//----------------------------------------------------------------------------
+//	/^M^\ Count Modula Plugin for VCV Rack - A standardised 4 channel gate input processor
+//	SIMD version of the GateProcessor - all states are returned as float_4 lane masks
+//  Copyright (C) 2023  Adam Verspaget
+//----------------------------------------------------------------------------
+#pragma once
+
+using simd::float_4;
+
+class GateProcessorSimd {
+	private:
+		// Schmitt trigger state starts high in the same way as dsp::SchmittTrigger
+		float_4 st = float_4::mask();
+		float_4 prevState = float_4::zero();
+		float_4 currentState = float_4::zero();
+
+	public:
+		// set the gates with the given values
+		float_4 set(float_4 value) {
+			// standard Schmitt trigger with 0.1 and 2 Volt thresholds
+			st = (value >= 2.0f) | (st & ~(value <= 0.1f));
+
+			prevState = currentState;
+			currentState = st;
+
+			return currentState;
+		}
+
+		// reset the gate processor
+		void reset() {
+			st = float_4::mask();
+			prevState = currentState = float_4::zero();
+		}
+
+		// reset a single lane of the gate processor
+		void reset(int lane) {
+			float_4 m = simd::movemaskInverse<float_4>(1 << lane);
+
+			st = st | m;
+			prevState = prevState & ~m;
+			currentState = currentState & ~m;
+		}
+
+		// gate high indicator
+		float_4 high() {
+			return currentState;
+		}
+
+		// gate low indicator
+		float_4 low() {
+			return ~currentState;
+		}
+
+		// indicates if the latest values caused a leading edge
+		float_4 leadingEdge() {
+			return currentState & ~prevState;
+		}
+
+		// indicates if the latest values caused a trailing edge
+		float_4 trailingEdge() {
+			return prevState & ~currentState;
+		}
+
+		// indicates if the latest values caused any edge
+		float_4 anyEdge() {
+			return prevState ^ currentState;
+		}
+
+		// gate state values for output
+		float_4 value() {
+			return currentState & 10.0f;
+		}
+
+		float_4 notValue() {
+			return ~currentState & 10.0f;
+		}
+
+		// gate state values for display
+		float_4 light() {
+			return currentState & 1.0f;
+		}
+
+		// gate state of the given lane
+		bool high(int lane) {
+			return simd::movemask(currentState) & (1 << lane);
+		}
+};
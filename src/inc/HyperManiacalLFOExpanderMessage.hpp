@@ -3,11 +3,21 @@
 //	For passing LDO details from the Hyper Maniacal LFO to the outpu expander
 //  Copyright (C) 2020  Adam Verspaget
 //----------------------------------------------------------------------------
+#include "ExpanderTopology.hpp"
 
 // utility macros 
 #define isExpanderModule(x) x->model == modelHyperManiacalLFOExpander
 #define isExpandableModule(x) x->model == modelHyperManiacalLFO
 
+// expander topology tests
+inline bool isHyperManiacalLFOExpander(Module *m) {
+	return isExpanderModule(m);
+}
+
+inline bool isHyperManiacalLFO(Module *m) {
+	return isExpandableModule(m);
+}
+
 struct HyperManiacalLFOExpanderMessage {
 	float sin[8] = {};
 	float saw[8] = {};
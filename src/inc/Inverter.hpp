@@ -1,35 +1,48 @@
 //----------------------------------------------------------------------------
 //	/^M^\ Count Modula Plugin for VCV Rack - Schmitt Trigger controlled logical inverter
+//	Templated on the sample type - states are bools for float and lane masks for float_4
 //  Copyright (C) 2019  Adam Verspaget
 //----------------------------------------------------------------------------
 #pragma once
 
-struct Inverter {
-	dsp::SchmittTrigger i;
-	dsp::SchmittTrigger e;
+using simd::float_4;
+
+template <typename T>
+struct TInverter {
+	typedef decltype(dsp::TSchmittTrigger<T>().isHigh()) state_t;
+	
+	dsp::TSchmittTrigger<T> i;
+	dsp::TSchmittTrigger<T> e;
 	
-	bool isHigh = true;
-	bool isEnabled = false;
+	state_t isHigh;
+	state_t isEnabled;
 	
-	float process(float in) {
-		return process(in, 10.0f);
+	TInverter() {
+		reset();
 	}
 	
-	float process(float in, float enable) {
+	T process(T in) {
+		return process(in, T(10.0f));
+	}
+	
+	T process(T in, T enable) {
 		i.process(in);
 		e.process(enable);
 		
 		isEnabled = e.isHigh();
 		
 		// invert or not based on the enable state
-		isHigh  = isEnabled ? !i.isHigh() : i.isHigh();
-		return isHigh ? 10.0f : 0.0f;
+		isHigh = i.isHigh() ^ isEnabled;
+		return simd::ifelse(isHigh, T(10.0f), T(0.0f));
 	}
 	
 	void reset() {
 		i.reset();
 		e.reset();
-		isHigh = true;
-		isEnabled = false;
+		isHigh = i.isHigh();
+		isEnabled = state_t(0);
 	}
-};
\ No newline at end of file
+};
+
+typedef TInverter<float> Inverter;
+typedef TInverter<float_4> InverterSimd;
@@ -0,0 +1,81 @@
+//------------------------------------------------------------------------
+//  /^M^\ Count Modula Plugin for VCV Rack - Lag Processor Bank
+//	Structure of arrays version of the LagProcessor processing 4 lags at a
+//	time. The slew rates only change with the rise and fall values so they
+//	are cached per group rather than being recalculated every sample.
+//  Copyright (C) 2023  Adam Verspaget
+//----------------------------------------------------------------------------
+#pragma once
+
+using simd::float_4;
+
+template <int SIZE>
+struct LagProcessorBank {
+	static const int NUM_GROUPS = (SIZE + 3) / 4;
+
+	float_4 out[NUM_GROUPS];
+	
+	// cached slew rates and the rise/fall values they were calculated for
+	float rise[NUM_GROUPS];
+	float fall[NUM_GROUPS];
+	float riseSlew[NUM_GROUPS];
+	float fallSlew[NUM_GROUPS];
+
+	LagProcessorBank() {
+		for (int g = 0; g < NUM_GROUPS; g++) {
+			rise[g] = fall[g] = -1.0f;
+			riseSlew[g] = fallSlew[g] = 0.0f;
+		}
+		
+		reset();
+	}
+	
+	// same curve as the LagProcessor
+	static float slewRate(float amount) {
+		// minimum and maximum slopes in volts per second
+		const float slewMin = 0.1;
+		const float slewMax = 10000.0;
+		
+		return slewMax * powf(slewMin / slewMax, amount);
+	}
+
+	// process the given values for the given group of 4 lags and return the lagged values
+	float_4 process(int g, float_4 in, float shape, float riseAmount, float fallAmount, float sampleTime) {
+		
+		// Amount of extra slew per voltage difference
+		const float shapeScale = 1/10.0;
+		
+		if (riseAmount != rise[g]) {
+			rise[g] = riseAmount;
+			riseSlew[g] = slewRate(riseAmount);
+		}
+		
+		if (fallAmount != fall[g]) {
+			fall[g] = fallAmount;
+			fallSlew[g] = slewRate(fallAmount);
+		}
+		
+		float_4 o = out[g];
+		float_4 rising = in > o;
+		float_4 falling = in < o;
+		
+		float_4 slew = simd::ifelse(rising, riseSlew[g], fallSlew[g]);
+		float_4 delta = slew * simd::crossfade(float_4(1.0f), shapeScale * simd::fabs(in - o), float_4(shape)) * sampleTime;
+		
+		// move towards the input without overshooting it
+		o = simd::ifelse(rising, simd::fmin(o + delta, in), simd::ifelse(falling, simd::fmax(o - delta, in), o));
+		out[g] = o;
+		
+		return o;
+	}
+	
+	// current value of the given lag
+	float value(int i) {
+		return out[i >> 2][i & 3];
+	}
+	
+	void reset() {
+		for (int g = 0; g < NUM_GROUPS; g++)
+			out[g] = float_4::zero();
+	}
+};
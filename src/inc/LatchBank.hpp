@@ -0,0 +1,56 @@
+//----------------------------------------------------------------------------
+//	/^M^\ Count Modula Plugin for VCV Rack - Latch bank
+//	Common state handling for the polyphonic flip flops. The latch states for
+//	up to 16 channels are held as bit masks with channel 1 in bit 0 so the
+//	latch logic for all channels is just a few bitwise operations.
+//  Copyright (C) 2023  Adam Verspaget
+//----------------------------------------------------------------------------
+#pragma once
+#include "GateProcessorSimd.hpp"
+
+using simd::float_4;
+
+struct LatchBank {
+	uint16_t stateQ = 0;
+	uint16_t stateNQ = 0xffff;
+
+	// number of channels to process in polyphonic mode - as many as there are on the inputs
+	static int channels(Input &a, Input &b, Input &c) {
+		return std::max(std::max(a.getChannels(), b.getChannels()), std::max(c.getChannels(), 1));
+	}
+
+	// bit mask of the channels in use for the given channel count
+	static uint16_t channelBits(int channels) {
+		return (uint16_t)((1 << channels) - 1);
+	}
+	
+	// convert the lane mask for the group of 4 channels starting at the given channel into channel bits
+	static uint16_t bits(float_4 mask, int c) {
+		return (uint16_t)(simd::movemask(mask) << c);
+	}
+	
+	// gets the current "Q" outputs for the group of 4 channels starting at the given channel
+	float_4 Q(int c) {
+		return simd::movemaskInverse<float_4>((stateQ >> c) & 0x0f) & 10.0f;
+	}
+	
+	// gets the current not Q outputs for the group of 4 channels starting at the given channel
+	float_4 NQ(int c) {
+		return simd::movemaskInverse<float_4>((stateNQ >> c) & 0x0f) & 10.0f;
+	}
+	
+	// gets the current "Q" output light value - channel 1 only
+	float QLight() {
+		return boolToLight((stateQ & 0x01));
+	}
+	
+	// gets the current not Q output light value - channel 1 only
+	float NQLight() {
+		return boolToLight((stateNQ & 0x01));
+	}
+	
+	void reset() {
+		stateQ = 0;
+		stateNQ = 0xffff;
+	}
+};
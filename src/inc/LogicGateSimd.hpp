@@ -0,0 +1,58 @@
+//----------------------------------------------------------------------------
+//	/^M^\ Count Modula Plugin for VCV Rack - SIMD Schmitt trigger logic
+//	Evaluates the AND/OR/XOR/NOT logic functions 4 channels at a time.
+//	All states are float_4 lane masks.
+//  Copyright (C) 2023  Adam Verspaget
+//----------------------------------------------------------------------------
+#pragma once
+#include "GateProcessorSimd.hpp"
+#include "Inverter.hpp"
+
+using simd::float_4;
+
+// lane mask for the channels in the group of 4 starting at the given channel that are below the given channel count.
+// used to normal an input to another in place of the channels it doesn't have
+inline float_4 channelMask(int c, int channels) {
+	return simd::movemaskInverse<float_4>((1 << clamp(channels - c, 0, 4)) - 1);
+}
+
+// 4 input logic gate using the standard gate input thresholds
+struct LogicGateSimd {
+	GateProcessorSimd a;
+	GateProcessorSimd b;
+	GateProcessorSimd c;
+	GateProcessorSimd d;
+
+	// set the gate inputs
+	void set(float_4 aIn, float_4 bIn, float_4 cIn, float_4 dIn) {
+		a.set(aIn);
+		b.set(bIn);
+		c.set(cIn);
+		d.set(dIn);
+	}
+	
+	float_4 andGate() {
+		return a.high() & b.high() & c.high() & d.high();
+	}
+	
+	float_4 orGate() {
+		return a.high() | b.high() | c.high() | d.high();
+	}
+	
+	// odd number of high inputs or, in one-hot mode, exactly one high input
+	float_4 xorGate(bool oneHot) {
+		float_4 n = (a.high() & 1.0f) + (b.high() & 1.0f) + (c.high() & 1.0f) + (d.high() & 1.0f);
+		
+		if (oneHot)
+			return (n == 1.0f);
+			
+		return (n == 1.0f) | (n == 3.0f);
+	}
+	
+	void reset() {
+		a.reset();
+		b.reset();
+		c.reset();
+		d.reset();
+	}
+};
@@ -3,15 +3,41 @@
 //	For passing control details from the Megalomaniac expander to the HMLFO
 //  Copyright (C) 2020  Adam Verspaget
 //----------------------------------------------------------------------------
+#include <atomic>
+#include "ExpanderTopology.hpp"
 
 // utility macros 
 #define isControllerModule(x) x->model == modelMegalomaniac
 #define isControllableModule(x) x->model == modelHyperManiacalLFO
 
+// expander topology tests
+inline bool isMegalomaniacController(Module *m) {
+	return isControllerModule(m);
+}
+
+inline bool isMegalomaniacControllable(Module *m) {
+	return isControllableModule(m);
+}
+
+// selection versions are handed out across all controllers so a newly attached
+// controller can never match the version left in the message by the one before it
+inline unsigned int megalomaniacNextVersion() {
+	static std::atomic<unsigned int> version(0);
+	return ++version;
+}
+
 struct MegalomaniacControllerMessage {
+	// the selections only change when the version does
+	unsigned int version = 0;
 	int selectedWaveform[6] = {};
 	int selectedRange[6] = {};
-	float mixLevel[6] = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f};
-	float fmValue[6] = {};
+	
+	// continuous values are streamed every sample in groups of 4 oscillators
+	simd::float_4 mixLevel[2] = {1.0f, 1.0f};
+	simd::float_4 fmValue[2] = {};
+	
+	// polyphonic rate values in groups of 4 channels
+	simd::float_4 fmValues[6][4] = {};
+	int channels = 1;
 };
 
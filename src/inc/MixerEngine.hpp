@@ -3,45 +3,84 @@
 //	Basic 4 input bipolar/unipolar mixer
 //  Copyright (C) 2019  Adam Verspaget
 //----------------------------------------------------------------------------
+#pragma once
+
+// mixer output saturation - linear up to the 10V knee then a quadratic curve that meets the 12V rails with zero slope
+#define MIXER_SATURATION_KNEE 10.0f
+#define MIXER_SATURATION_RANGE 2.0f
+
+template <typename T>
+T mixerSaturate(T in) {
+	T a = simd::fabs(in);
+	T e = simd::fmin(simd::fmax(a - MIXER_SATURATION_KNEE, 0.0f), 2.0f * MIXER_SATURATION_RANGE);
+	T out = simd::fmin(a, MIXER_SATURATION_KNEE) + e - (e * e / (4.0f * MIXER_SATURATION_RANGE));
+
+	return simd::ifelse(in < 0.0f, -out, out);
+}
+
+// T can be float for a single channel or float_4 to mix 4 polyphonic channels at once
+template <typename T = float>
 struct MixerEngine {
-	float overloadLevel = 0.0f;
-	float mixLevel = 0.0f;
+	T overloadLevel = 0.0f;
+	T mixLevel = 0.0f;
 	bool limitToRails = true;
-	
+
+	// raw control values - used to detect a change
+	float inputLevels[4] = {-1.0f, -1.0f, -1.0f, -1.0f};
+	float outputLevel = -1.0f;
+	bool bipolar = false;
+
+	// converted levels actually applied to the inputs, including the output level
 	float level1 = 0.0f;
 	float level2 = 0.0f;
 	float level3 = 0.0f;
 	float level4 = 0.0f;
-	
-	float process (float input1, float input2, float input3, float input4, float inputLevel1, float inputLevel2, float inputLevel3, float inputLevel4, float outputLevel, bool bipolar) {
 
-		// convert to unipolar
+	// set the mix levels - the conversion is only done when one of them actually changes
+	void setLevels(float inputLevel1, float inputLevel2, float inputLevel3, float inputLevel4, float outLevel, bool bipolarMode) {
+		if (inputLevel1 == inputLevels[0] && inputLevel2 == inputLevels[1] && inputLevel3 == inputLevels[2] && inputLevel4 == inputLevels[3]
+			&& outLevel == outputLevel && bipolarMode == bipolar)
+			return;
+
+		inputLevels[0] = inputLevel1;
+		inputLevels[1] = inputLevel2;
+		inputLevels[2] = inputLevel3;
+		inputLevels[3] = inputLevel4;
+		outputLevel = outLevel;
+		bipolar = bipolarMode;
+
+		// convert to bipolar
 		if (bipolar) {
-			level1 = (inputLevel1 * 2.0f) - 1.0f;
-			level2 = (inputLevel2 * 2.0f) - 1.0f;
-			level3 = (inputLevel3 * 2.0f) - 1.0f;
-			level4 = (inputLevel4 * 2.0f) - 1.0f;
+			level1 = ((inputLevel1 * 2.0f) - 1.0f) * outputLevel;
+			level2 = ((inputLevel2 * 2.0f) - 1.0f) * outputLevel;
+			level3 = ((inputLevel3 * 2.0f) - 1.0f) * outputLevel;
+			level4 = ((inputLevel4 * 2.0f) - 1.0f) * outputLevel;
 		}
 		else {
-			level1 = inputLevel1;
-			level2 = inputLevel2;
-			level3 = inputLevel3;
-			level4 = inputLevel4;
+			level1 = inputLevel1 * outputLevel;
+			level2 = inputLevel2 * outputLevel;
+			level3 = inputLevel3 * outputLevel;
+			level4 = inputLevel4 * outputLevel;
 		}
-		
-		float out = outputLevel * ((input1 * level1) +
-									(input2 * level2) +
-									(input3 * level3) +
-									(input4 * level4));
-		
-		overloadLevel =  (fabs(out) > 10.0f) ? 1.0f : 0.0f;
-		
-		// TODO: saturation rather than hard limit although my hardware mixers just clip
+	}
+
+	// mix the given inputs using the current levels
+	T process (T input1, T input2, T input3, T input4) {
+		T out = (input1 * level1) + (input2 * level2) + (input3 * level3) + (input4 * level4);
+
+		overloadLevel = simd::ifelse(simd::fabs(out) > 10.0f, 1.0f, 0.0f);
+
 		if (limitToRails)
-			out = clamp(out, -12.0f, 12.0f);
-		
-		mixLevel = fminf(fabs(out) / 10.0f, 1.0f);
+			out = mixerSaturate(out);
+
+		mixLevel = simd::fmin(simd::fabs(out) / 10.0f, 1.0f);
 
 		return out;
 	}
+
+	T process (T input1, T input2, T input3, T input4, float inputLevel1, float inputLevel2, float inputLevel3, float inputLevel4, float outputLevel, bool bipolar) {
+		setLevels(inputLevel1, inputLevel2, inputLevel3, inputLevel4, outputLevel, bipolar);
+
+		return process(input1, input2, input3, input4);
+	}
 };
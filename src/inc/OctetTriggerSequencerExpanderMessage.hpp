@@ -4,6 +4,7 @@
 //  and the octet sequencer expander modules
 //  Copyright (C) 2021  Adam Verspaget
 //----------------------------------------------------------------------------
+#include "ExpanderTopology.hpp"
 
 // utility macros 
 #define isExpanderModule(x) x->model == modelOctetTriggerSequencerCVExpander || x->model == modelOctetTriggerSequencerGateExpander 
@@ -18,6 +19,15 @@
 // count to bit mappping
 #define STEP_MAP const int stepMap[9] = {0, 128, 64, 32, 16, 8, 4, 2, 1}
 
+// expander topology tests
+inline bool isOctetTriggerSequencerExpander(Module *m) {
+	return isExpanderModule(m);
+}
+
+inline bool isOctetTriggerSequencerChainModule(Module *m) {
+	return isExpandableModule(m);
+}
+
 struct OctetTriggerSequencerExpanderMessage {
 	
 	OctetTriggerSequencerExpanderMessage() {
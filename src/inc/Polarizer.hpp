@@ -1,28 +1,45 @@
 //----------------------------------------------------------------------------
 //	/^M^\ Count Modula Plugin for VCV Rack - Polarizer
 //	Basic polarizing functionality
+//	Templated on the sample type so poly modules can process 4 channels at a time
 //  Copyright (C) 2019  Adam Verspaget
 //----------------------------------------------------------------------------
 #pragma once
-struct Polarizer {
-	float positiveLevel = 0.0f;
-	float negativeLevel = 0.0f;
-	float out = 0.0f;
-	
-	float process(float in, float manual, float cv, float cvLevel) {
 
-		float multiplier = manual + (cv * cvLevel / 5.0f); // 10V cv = 2 x amplification
-		out = in * multiplier;
-		out = clamp(out, -10.0f, 10.0f); 
-			
-		positiveLevel = multiplier > 0.0f ? fminf(multiplier, 1.0f) : 0.0f;
-		negativeLevel = multiplier < 0.0f ? fminf(-multiplier, 1.0f) : 0.0f;
+using simd::float_4;
 
+template <typename T>
+struct TPolarizer {
+	T multiplier = 0.0f;
+	T out = 0.0f;
+	
+	// amount of polarization for the given controls
+	T polarity(float manual, T cv, float cvLevel) {
+		multiplier = manual + (cv * cvLevel / 5.0f); // 10V cv = 2 x amplification
+		return multiplier;
+	}
+	
+	T process(T in, float manual, T cv, float cvLevel) {
+		out = in * polarity(manual, cv, cvLevel);
+		out = clamp(out, T(-10.0f), T(10.0f)); 
+		
 		return out;		
 	}
 	
+	// level indicators - only needed at the UI rate so they're worked out on demand
+	T positiveLevel() {
+		return clamp(multiplier, T(0.0f), T(1.0f));
+	}
+	
+	T negativeLevel() {
+		return clamp(-multiplier, T(0.0f), T(1.0f));
+	}
+	
 	void reset() {
-		positiveLevel = 0.0f;
-		negativeLevel = 0.0f;
+		multiplier = 0.0f;
+		out = 0.0f;
 	}
-};
\ No newline at end of file
+};
+
+typedef TPolarizer<float> Polarizer;
+typedef TPolarizer<float_4> PolarizerSimd;
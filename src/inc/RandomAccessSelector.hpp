@@ -0,0 +1,95 @@
+//----------------------------------------------------------------------------
+//	/^M^\ Count Modula Plugin for VCV Rack - Random access selector
+//	Select gate handling for the random access switches. Each channel keeps
+//	its own selection so the switches can route polyphonic signals with
+//	every channel going its own way.
+//  Copyright (C) 2023  Adam Verspaget
+//----------------------------------------------------------------------------
+#pragma once
+#include "GateProcessorSimd.hpp"
+
+using simd::float_4;
+using simd::int32_4;
+
+struct RandomAccessSelector {
+	static const int NUM_GROUPS = PORT_MAX_CHANNELS / 4;
+
+	GateProcessorSimd gpSelect[8][NUM_GROUPS];
+	int32_4 selection[NUM_GROUPS];
+	int32_4 prevSelection[NUM_GROUPS];
+	
+	// channel bit masks of the channels that saw a select edge and the channels that changed selection
+	uint16_t edges = 0;
+	uint16_t changes = 0;
+	
+	RandomAccessSelector() {
+		for (int g = 0; g < NUM_GROUPS; g++)
+			selection[g] = prevSelection[g] = int32_4::zero();
+	}
+	
+	// process the given select buttons and inputs for the given number of channels
+	void process(Param *buttons, Input *selects, int channels) {
+		edges = changes = 0;
+		
+		for (int c = 0; c < channels; c += 4) {
+			int g = c / 4;
+			
+			// gather the select edges into a bit per select for each channel
+			int bits[4] = {};
+			for (int i = 0; i < 8; i++) {
+				gpSelect[i][g].set(buttons[i].getValue() > 0.5f ? float_4(10.0f) : selects[i].getPolyVoltageSimd<float_4>(c));
+				
+				int m = simd::movemask(gpSelect[i][g].leadingEdge());
+				for (int l = 0; l < 4; l++)
+					bits[l] |= ((m >> l) & 0x01) << i;
+			}
+			
+			for (int l = 0; l < 4 && c + l < channels; l++) {
+				if (bits[l]) {
+					// the highest numbered select wins if more than one arrives at the same time
+					selection[g][l] = 31 - __builtin_clz(bits[l]);
+					edges |= 1 << (c + l);
+				}
+			}
+			
+			changes |= simd::movemask(selection[g] != prevSelection[g]) << c;
+			prevSelection[g] = selection[g];
+		}
+		
+		changes &= (1 << channels) - 1;
+	}
+	
+	// lane mask of the channels in the group of 4 starting at the given channel that have selected the given index
+	float_4 selected(int c, int index) {
+		return float_4::cast(selection[c >> 2] == int32_4(index));
+	}
+	
+	// lane mask of the channels in the group of 4 starting at the given channel that saw a select edge
+	float_4 sampled(int c) {
+		return simd::movemaskInverse<float_4>((edges >> c) & 0x0f);
+	}
+	
+	// bit mask of the channels that have selected the given index
+	int selectedBits(int index, int channels) {
+		int bits = 0;
+		for (int c = 0; c < channels; c += 4)
+			bits |= simd::movemask(selection[c >> 2] == int32_4(index)) << c;
+		
+		return bits & ((1 << channels) - 1);
+	}
+	
+	int get(int c) {
+		return selection[c >> 2][c & 3];
+	}
+	
+	void set(int c, int index) {
+		selection[c >> 2][c & 3] = clamp(index, 0, 7);
+	}
+	
+	// set the selection of all channels
+	void set(int index) {
+		int32_4 s = int32_4(clamp(index, 0, 7));
+		for (int g = 0; g < NUM_GROUPS; g++)
+			selection[g] = s;
+	}
+};
@@ -4,6 +4,7 @@
 //  and the sequencer channel expander module and gate expander modules
 //  Copyright (C) 2020  Adam Verspaget
 //----------------------------------------------------------------------------
+#include "ExpanderChain.hpp"
 
 // utility macros 
 #if SEQ_NUM_STEPS == 8
@@ -48,3 +49,17 @@ struct SequencerChannelMessage {
 	}
 };
 
+// expander chain family membership - these depend on the number of steps so are kept local to each module
+static inline bool isSequencerChannelExpander(Module *m) {
+	return isExpanderModule(m);
+}
+
+static inline bool isSequencerChannelMaster(Module *m) {
+#if SEQ_NUM_STEPS == 8
+	return m->model == modelSequencer8 || m->model == modelSequenceEncoder;
+#elif SEQ_NUM_STEPS == 16
+	return m->model == modelSequencer16 || m->model == modelSequenceEncoder;
+#else
+	return false;
+#endif
+}
@@ -3,6 +3,7 @@
 //	For passing sequence details to and from sequencer expander modules
 //  Copyright (C) 2019  Adam Verspaget
 //----------------------------------------------------------------------------
+#include "ExpanderChain.hpp"
 
 #define SEQUENCER_EXP_MAX_CHANNELS 4
 
@@ -19,7 +20,7 @@
 
 // utility macros 
 #define isExpanderModule(x) x->model == modelSequencerExpanderCV8 || x->model == modelSequencerExpanderOut8 || x->model == modelSequencerExpanderTrig8 || x->model == modelSequencerExpanderRM8 || x->model == modelSequencerExpanderLog8 || x->model == modelSequencerExpanderTSG
-#define isExpandableModule(x) x->model == modelTriggerSequencer8 || x->model == modelStepSequencer8 || x->model == modelBinarySequencer || x->model == modelBasicSequencer8 || x->model == modelBurstGenerator || x->model == modelGatedComparator
+#define isExpandableModule(x) x->model == modelTriggerSequencer8 || x->model == modelTriggerSequencer16 || x->model == modelStepSequencer8 || x->model == modelBinarySequencer || x->model == modelBasicSequencer8 || x->model == modelBurstGenerator || x->model == modelGatedComparator
 
 struct SequencerExpanderMessage {
 	
@@ -81,6 +82,23 @@ struct SequencerExpanderMessage {
 	}
 };
 
+// expander chain family membership
+inline bool isSequencerExpander(Module *m) {
+	return isExpanderModule(m);
+}
+
+inline bool isSequencerExpanderMaster(Module *m) {
+	return isExpandableModule(m);
+}
+
+// all sequencer expanders are driven directly by their master when part of a chain
+struct SequencerExpander : ChainedExpander<SequencerExpanderMessage> {
+	SequencerExpander() {
+		isChainExpander = isSequencerExpander;
+		isChainMaster = isSequencerExpanderMaster;
+	}
+};
+
 // custom channel indicator
 struct CountModulaLightRGYB : GrayModuleLightWidget {
 	CountModulaLightRGYB() {
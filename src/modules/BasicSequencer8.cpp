@@ -80,7 +80,7 @@ struct BasicSequencer8 : Module {
 	#include "../themes/variables.hpp"
 	
 #ifdef SEQUENCER_EXP_MAX_CHANNELS	
-	SequencerExpanderMessage rightMessages[2][1]; // messages to right module (expander)
+	ExpanderChain<SequencerExpanderMessage> expanderChain;	// expanders driven directly from this module
 #endif
 
 	BasicSequencer8() {
@@ -120,12 +120,6 @@ struct BasicSequencer8 : Module {
 		configOutput(GATE_OUTPUT, "Gate");
 		configOutput(CV_OUTPUT, "CV");
 		configOutput(CVI_OUTPUT, "Inverted CV");
-		
-#ifdef SEQUENCER_EXP_MAX_CHANNELS	
-		// expander
-		rightExpander.producerMessage = rightMessages[0];
-		rightExpander.consumerMessage = rightMessages[1];	
-#endif
 
 		// set the theme from the current default value
 		#include "../themes/setDefaultTheme.hpp"
@@ -237,6 +231,13 @@ struct BasicSequencer8 : Module {
 		lights[DIR_LIGHTS + 2].setBrightness(boolToLight(directionMode == FORWARD)); 	// green
 	}
 	
+#ifdef SEQUENCER_EXP_MAX_CHANNELS
+	// any change in the layout means the expander chain needs to be resolved again
+	void onExpanderChange(const ExpanderChangeEvent &e) override {
+		expanderChainGeneration()++;
+	}
+#endif
+
 	void process(const ProcessArgs &args) override {
 
 		// grab all the common input values up front
@@ -411,26 +412,25 @@ struct BasicSequencer8 : Module {
 	
 #ifdef SEQUENCER_EXP_MAX_CHANNELS	
 		// set up details for the expander
-		if (rightExpander.module) {
-			if (isExpanderModule(rightExpander.module)) {
-				
-				SequencerExpanderMessage *messageToExpander = (SequencerExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
+		if (expanderChain.resolve(this, isSequencerExpander)) {
+			
+			SequencerExpanderMessage *messageToExpander = &expanderChain.message;
 
-				// set any potential expander module's channel number
-				messageToExpander->setAllChannels(0);
-	
-				// add the channel counters and gates
-				for (int i = 0; i < SEQUENCER_EXP_MAX_CHANNELS ; i++) {
-					messageToExpander->counters[i] = count;
-					messageToExpander->clockStates[i] =	gateClock.high();
-					messageToExpander->runningStates[i] = running;
-				}
-				
-				// finally, let all potential expanders know where we came from
-				messageToExpander->masterModule = SEQUENCER_EXP_MASTER_MODULE_BASIC;
-				
-				rightExpander.module->leftExpander.messageFlipRequested = true;
+			// set any potential expander module's channel number
+			messageToExpander->setAllChannels(0);
+
+			// add the channel counters and gates
+			for (int i = 0; i < SEQUENCER_EXP_MAX_CHANNELS ; i++) {
+				messageToExpander->counters[i] = count;
+				messageToExpander->clockStates[i] =	gateClock.high();
+				messageToExpander->runningStates[i] = running;
 			}
+			
+			// finally, let all potential expanders know where we came from
+			messageToExpander->masterModule = SEQUENCER_EXP_MASTER_MODULE_BASIC;
+			
+			// drive the expanders directly so the whole chain sees this sample
+			expanderChain.process(args);
 		}
 #endif		
 	}
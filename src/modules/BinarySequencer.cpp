@@ -64,7 +64,7 @@ struct BinarySequencer : Module {
 	#include "../themes/variables.hpp"
 	
 #ifdef SEQUENCER_EXP_MAX_CHANNELS	
-	SequencerExpanderMessage rightMessages[2][1]; // messages to right module (expander)
+	ExpanderChain<SequencerExpanderMessage> expanderChain;	// expanders driven directly from this module
 #endif
 	
 	BinarySequencer() {
@@ -102,12 +102,6 @@ struct BinarySequencer : Module {
 		outputInfos[CLOCK_OUTPUT]->description = "Outputs the internal clock or follows the external clock if connected";
 		outputInfos[TRIGGER_OUTPUT]->description = "Outputs a trigger for every clock pulse";
 
-#ifdef SEQUENCER_EXP_MAX_CHANNELS	
-		// expander
-		rightExpander.producerMessage = rightMessages[0];
-		rightExpander.consumerMessage = rightMessages[1];
-#endif		
-
 		// set the theme from the current default value
 		#include "../themes/setDefaultTheme.hpp"
 	}
@@ -153,6 +147,13 @@ struct BinarySequencer : Module {
 		startUpCounter = 20;		
 	}		
 	
+#ifdef SEQUENCER_EXP_MAX_CHANNELS
+	// any change in the layout means the expander chain needs to be resolved again
+	void onExpanderChange(const ExpanderChangeEvent &e) override {
+		expanderChainGeneration()++;
+	}
+#endif
+
 	void process(const ProcessArgs &args) override {
 
 		// generate the internal clock value
@@ -259,26 +260,25 @@ struct BinarySequencer : Module {
 		
 #ifdef SEQUENCER_EXP_MAX_CHANNELS	
 		// set up details for the expander
-		if (rightExpander.module) {
-			if (isExpanderModule(rightExpander.module)) {
-				
-				SequencerExpanderMessage *messageToExpander = (SequencerExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
+		if (expanderChain.resolve(this, isSequencerExpander)) {
+			
+			SequencerExpanderMessage *messageToExpander = &expanderChain.message;
 
-				// set any potential expander module's channel number
-				messageToExpander->setAllChannels(0);
-	
-				// add the channel counters and gates
-				for (int i = 0; i < SEQUENCER_EXP_MAX_CHANNELS ; i++) {
-					messageToExpander->counters[i] = counter;
-					messageToExpander->clockStates[i] =	gateClock.high();
-					messageToExpander->runningStates[i] = gateRun.high();
-				}		
-				
-				// finally, let all potential expanders know where we came from
-				messageToExpander->masterModule = SEQUENCER_EXP_MASTER_MODULE_BINARY;
-				
-				rightExpander.module->leftExpander.messageFlipRequested = true;
-			}
+			// set any potential expander module's channel number
+			messageToExpander->setAllChannels(0);
+
+			// add the channel counters and gates
+			for (int i = 0; i < SEQUENCER_EXP_MAX_CHANNELS ; i++) {
+				messageToExpander->counters[i] = counter;
+				messageToExpander->clockStates[i] =	gateClock.high();
+				messageToExpander->runningStates[i] = gateRun.high();
+			}		
+			
+			// finally, let all potential expanders know where we came from
+			messageToExpander->masterModule = SEQUENCER_EXP_MASTER_MODULE_BINARY;
+			
+			// drive the expanders directly so the whole chain sees this sample
+			expanderChain.process(args);
 		}
 #endif	
 	}
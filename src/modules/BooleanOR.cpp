@@ -5,42 +5,13 @@
 //----------------------------------------------------------------------------
 #include "../CountModula.hpp"
 #include "../inc/Utility.hpp"
-#include "../inc/Inverter.hpp"
-#include "../inc/GateProcessor.hpp"
+#include "../inc/LogicGateSimd.hpp"
 
 // set the module name for the theme selection functions
 #define THEME_MODULE_NAME BooleanOR
 #define PANEL_FILE "BooleanOR.svg"
 
-struct OrGate {
-	GateProcessor a;
-	GateProcessor b;
-	GateProcessor c;
-	GateProcessor d;
-
-	bool isHigh = false;
-	
-	float process (float aIn, float bIn, float cIn, float dIn) {
-		
-		// process the OR function
-		isHigh = false;
-		isHigh |= a.set(aIn);
-		isHigh |= b.set(bIn);
-		isHigh |= c.set(cIn);
-		isHigh |= d.set(dIn);
-		
-		return boolToGate(isHigh);
-	}
-	
-	void reset() {
-		a.reset();
-		b.reset();
-		c.reset();
-		d.reset();
-		
-		isHigh = false;
-	}	
-};
+using simd::float_4;
 
 struct BooleanOR : Module {
 	enum ParamIds {
@@ -63,12 +34,10 @@ struct BooleanOR : Module {
 		NUM_LIGHTS
 	};
 
-	OrGate gate[PORT_MAX_CHANNELS];
-	Inverter inverter[PORT_MAX_CHANNELS];
+	LogicGateSimd gate[PORT_MAX_CHANNELS / 4];
+	InverterSimd inverter[PORT_MAX_CHANNELS / 4];
 
 	int numChans, bChannels, cChannels, dChannels, iChannels;
-	float inA, inB, inC, inD;
-	float out;
 	bool iConnected;
 	
 	// add the variables we'll use when managing themes
@@ -113,7 +82,7 @@ struct BooleanOR : Module {
 	}	
 	
 	void onReset() override {
-		for (int i = 0; i < PORT_MAX_CHANNELS; i++) {
+		for (int i = 0; i < PORT_MAX_CHANNELS / 4; i++) {
 			gate[i].reset();
 			inverter[i].reset();
 		}
@@ -133,25 +102,27 @@ struct BooleanOR : Module {
 			outputs[OR_OUTPUT].setChannels(numChans);
 			outputs[INV_OUTPUT].setChannels(numChans);
 			
-			for (int c = 0; c < numChans; c++) {
-				inA = inputs[A_INPUT].getPolyVoltage(c);
-				inB = c < bChannels ? inputs[B_INPUT].getVoltage(c) : inA;
-				inC = c < cChannels ? inputs[C_INPUT].getVoltage(c) : inB;
-				inD = c < dChannels ? inputs[D_INPUT].getVoltage(c) : inC;
+			// process 4 channels at a time, any channels missing from B, C or D are normalled to the previous input
+			for (int c = 0; c < numChans; c += 4) {
+				float_4 inA = inputs[A_INPUT].getPolyVoltageSimd<float_4>(c);
+				float_4 inB = simd::ifelse(channelMask(c, bChannels), inputs[B_INPUT].getVoltageSimd<float_4>(c), inA);
+				float_4 inC = simd::ifelse(channelMask(c, cChannels), inputs[C_INPUT].getVoltageSimd<float_4>(c), inB);
+				float_4 inD = simd::ifelse(channelMask(c, dChannels), inputs[D_INPUT].getVoltageSimd<float_4>(c), inC);
 				
 				//perform the logic
-				out =  gate[c].process(inA, inB, inC, inD);
-				outputs[OR_OUTPUT].setVoltage(out, c);
+				gate[c / 4].set(inA, inB, inC, inD);
+				float_4 out = gate[c / 4].orGate() & 10.0f;
+				outputs[OR_OUTPUT].setVoltageSimd(out, c);
 			
 				if (!iConnected)
-					outputs[INV_OUTPUT].setVoltage(inverter[c].process(out), c);		
+					outputs[INV_OUTPUT].setVoltageSimd(inverter[c / 4].process(out), c);		
 			}
 	
 			if (iConnected) {
 				iChannels = inputs[I_INPUT].getChannels();
 				outputs[INV_OUTPUT].setChannels(iChannels);
-				for (int c = 0; c < iChannels; c++) {
-					outputs[INV_OUTPUT].setVoltage(inverter[c].process(inputs[I_INPUT].getVoltage(c)), c);
+				for (int c = 0; c < iChannels; c += 4) {
+					outputs[INV_OUTPUT].setVoltageSimd(inverter[c / 4].process(inputs[I_INPUT].getVoltageSimd<float_4>(c)), c);
 				}
 			}
 		}
@@ -162,8 +133,8 @@ struct BooleanOR : Module {
 			if (iConnected) {
 				iChannels = inputs[I_INPUT].getChannels();
 				outputs[INV_OUTPUT].setChannels(iChannels);
-				for (int c = 0; c < iChannels; c++) {
-					outputs[INV_OUTPUT].setVoltage(inverter[c].process(inputs[I_INPUT].getVoltage(c)), c);
+				for (int c = 0; c < iChannels; c += 4) {
+					outputs[INV_OUTPUT].setVoltageSimd(inverter[c / 4].process(inputs[I_INPUT].getVoltageSimd<float_4>(c)), c);
 				}
 			}
 			else {
@@ -5,13 +5,14 @@
 //----------------------------------------------------------------------------
 #include "../CountModula.hpp"
 #include "../inc/Utility.hpp"
-#include "../inc/Inverter.hpp"
-#include "../inc/GateProcessor.hpp"
+#include "../inc/LogicGateSimd.hpp"
 
 // set the module name for the theme selection functions
 #define THEME_MODULE_NAME BooleanVCNOT
 #define PANEL_FILE "BooleanVCNOT.svg"
 
+using simd::float_4;
+
 struct BooleanVCNOT : Module {
 	enum ParamIds {
 		NUM_PARAMS
@@ -29,7 +30,7 @@ struct BooleanVCNOT : Module {
 		NUM_LIGHTS
 	};
 
-	Inverter inverter;
+	InverterSimd inverter[2][PORT_MAX_CHANNELS / 4];
 	
 	// add the variables we'll use when managing themes
 	#include "../themes/variables.hpp"
@@ -68,7 +69,10 @@ struct BooleanVCNOT : Module {
 	}	
 	
 	void onReset() override {
-		inverter.reset();
+		for (int i = 0; i < 2; i++) {
+			for (int j = 0; j < PORT_MAX_CHANNELS / 4; j++)
+				inverter[i][j].reset();
+		}
 	}
 	
 	void process(const ProcessArgs &args) override {
@@ -82,17 +86,18 @@ struct BooleanVCNOT : Module {
 				outputs[INV_OUTPUT + i].setChannels(numChannels);
 				bool enable = inputs[ENABLE_INPUT + i].isConnected();
 
-				int e = 0;
-				for (int c = 0; c < numChannels; c++) {
-					float inv = 10.0f;
-					
-					if (enable && e < numInvChannels)
-						inv = inputs[ENABLE_INPUT + i].getVoltage(e);
+				// a monophonic enable applies to all channels, a polyphonic one enables the channels it has
+				for (int c = 0; c < numChannels; c += 4) {
+					float_4 inv = 10.0f;
 					
-					if (numInvChannels > 1)
-						e++;
+					if (enable) {
+						if (numInvChannels == 1)
+							inv = inputs[ENABLE_INPUT + i].getVoltage();
+						else
+							inv = simd::ifelse(channelMask(c, numInvChannels), inputs[ENABLE_INPUT + i].getVoltageSimd<float_4>(c), 10.0f);
+					}
 					
-					outputs[INV_OUTPUT + i].setVoltage(inverter.process(inputs[LOGIC_INPUT + i].getVoltage(c), inv), c);
+					outputs[INV_OUTPUT + i].setVoltageSimd(inverter[i][c / 4].process(inputs[LOGIC_INPUT + i].getVoltageSimd<float_4>(c), inv), c);
 				}
 			}
 			else
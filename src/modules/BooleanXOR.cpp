@@ -5,52 +5,13 @@
 //----------------------------------------------------------------------------
 #include "../CountModula.hpp"
 #include "../inc/Utility.hpp"
-#include "../inc/Inverter.hpp"
-#include "../inc/GateProcessor.hpp"
+#include "../inc/LogicGateSimd.hpp"
 
 // set the module name for the theme selection functions
 #define THEME_MODULE_NAME BooleanXOR
 #define PANEL_FILE "BooleanXOR.svg"
 
-struct XorGate {
-	GateProcessor a;
-	GateProcessor b;
-	GateProcessor c;
-	GateProcessor d;
-
-	bool isHigh = false;
-	
-	float process (float aIn, float bIn, float cIn, float dIn, bool onehot) {
-		int i = 0;
-		i += (int)(a.set(aIn));
-		i += (int)(b.set(bIn));
-		i += (int)(c.set(cIn));
-		i += (int)(d.set(dIn));
-
-		// process the XOR function
-		// int i = 0;
-		// if (a.high()) i++;
-		// if (b.high()) i++;
-		// if (c.high()) i++;
-		// if (d.high()) i++;
-		
-		if (onehot)
-			isHigh = i == 1;
-		else
-			isHigh = (i > 0 && isOdd(i));
-		
-		return boolToGate(isHigh);
-	}
-	
-	void reset() {
-		a.reset();
-		b.reset();
-		c.reset();
-		d.reset();
-		
-		isHigh = false;
-	}
-};
+using simd::float_4;
 
 struct BooleanXOR : Module {
 	enum ParamIds {
@@ -75,12 +36,10 @@ struct BooleanXOR : Module {
 		NUM_LIGHTS
 	};
 
-	XorGate gate[PORT_MAX_CHANNELS];
-	Inverter inverter[PORT_MAX_CHANNELS];
+	LogicGateSimd gate[PORT_MAX_CHANNELS / 4];
+	InverterSimd inverter[PORT_MAX_CHANNELS / 4];
 
 	int numChans, bChannels, cChannels, dChannels, iChannels;
-	float inA, inB, inC, inD;
-	float out;
 	bool iConnected, oneHot;
 	
 	// add the variables we'll use when managing themes
@@ -131,7 +90,7 @@ struct BooleanXOR : Module {
 	}	
 	
 	void onReset() override {
-		for (int i = 0; i < PORT_MAX_CHANNELS; i++) {
+		for (int i = 0; i < PORT_MAX_CHANNELS / 4; i++) {
 			gate[i].reset();
 			inverter[i].reset();
 		}
@@ -155,25 +114,27 @@ struct BooleanXOR : Module {
 			outputs[XOR_OUTPUT].setChannels(numChans);
 			outputs[INV_OUTPUT].setChannels(numChans);
 			
-			for (int c = 0; c < numChans; c++) {
-				inA = inputs[A_INPUT].getPolyVoltage(c);
-				inB = c < bChannels ? inputs[B_INPUT].getVoltage(c) : 0.0f;
-				inC = c < cChannels ? inputs[C_INPUT].getVoltage(c) : 0.0f;
-				inD = c < dChannels ? inputs[D_INPUT].getVoltage(c) : 0.0f;
+			// process 4 channels at a time, any channels missing from B, C or D are treated as low
+			for (int c = 0; c < numChans; c += 4) {
+				float_4 inA = inputs[A_INPUT].getPolyVoltageSimd<float_4>(c);
+				float_4 inB = inputs[B_INPUT].getVoltageSimd<float_4>(c) & channelMask(c, bChannels);
+				float_4 inC = inputs[C_INPUT].getVoltageSimd<float_4>(c) & channelMask(c, cChannels);
+				float_4 inD = inputs[D_INPUT].getVoltageSimd<float_4>(c) & channelMask(c, dChannels);
 				
 				//perform the logic
-				out = gate[c].process(inA, inB, inC, inD, oneHot);
-				outputs[XOR_OUTPUT].setVoltage(out, c);
+				gate[c / 4].set(inA, inB, inC, inD);
+				float_4 out = gate[c / 4].xorGate(oneHot) & 10.0f;
+				outputs[XOR_OUTPUT].setVoltageSimd(out, c);
 			
 				if (!iConnected)
-					outputs[INV_OUTPUT].setVoltage(inverter[c].process(out), c);		
+					outputs[INV_OUTPUT].setVoltageSimd(inverter[c / 4].process(out), c);		
 			}
 	
 			if (iConnected) {
 				iChannels = inputs[I_INPUT].getChannels();
 				outputs[INV_OUTPUT].setChannels(iChannels);
-				for (int c = 0; c < iChannels; c++) {
-					outputs[INV_OUTPUT].setVoltage(inverter[c].process(inputs[I_INPUT].getVoltage(c)), c);
+				for (int c = 0; c < iChannels; c += 4) {
+					outputs[INV_OUTPUT].setVoltageSimd(inverter[c / 4].process(inputs[I_INPUT].getVoltageSimd<float_4>(c)), c);
 				}
 			}
 		}
@@ -184,8 +145,8 @@ struct BooleanXOR : Module {
 			if (iConnected) {
 				iChannels = inputs[I_INPUT].getChannels();
 				outputs[INV_OUTPUT].setChannels(iChannels);
-				for (int c = 0; c < iChannels; c++) {
-					outputs[INV_OUTPUT].setVoltage(inverter[c].process(inputs[I_INPUT].getVoltage(c)), c);
+				for (int c = 0; c < iChannels; c += 4) {
+					outputs[INV_OUTPUT].setVoltageSimd(inverter[c / 4].process(inputs[I_INPUT].getVoltageSimd<float_4>(c)), c);
 				}
 			}
 			else {
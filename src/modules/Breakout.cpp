@@ -10,6 +10,8 @@
 #define THEME_MODULE_NAME Breakout
 #define PANEL_FILE "Breakout.svg"
 
+using simd::float_4;
+
 struct Breakout : Module {
 	enum ParamIds {
 		CHANNEL_PARAM,
@@ -30,9 +32,7 @@ struct Breakout : Module {
 	};
 
 	int numChannels;
-	float v;
-	int start, end;
-	int prevStart;
+	int start;
 
 	int processCount = 8;
 	
@@ -52,20 +52,21 @@ struct Breakout : Module {
 	
 		processCount = 8;
 		start = 0;
-		end = 8;
-		prevStart = -1;
-		setIoLabels();
+		
+		for (int c = 0; c < 8; c++) {
+			configInput(RECEIVE_INPUTS + c, ioLabels[c] + " receive");
+			configOutput(SEND_OUTPUTS + c, ioLabels[c] + " send");
+		}
 		
 		// set the theme from the current default value
 		#include "../themes/setDefaultTheme.hpp"
 	}
 	
-	void setIoLabels() {
-		int s = start;
+	// rename the send/receive ports for the given channel range - called from the widget, never from process()
+	void setIoLabels(int first) {
 		for (int c = 0; c < 8; c++) {
-			configInput(RECEIVE_INPUTS + c, ioLabels[s] + " receive");
-			configOutput(SEND_OUTPUTS + c, ioLabels[s] + " send");
-			s++;
+			inputInfos[RECEIVE_INPUTS + c]->name = ioLabels[first + c] + " receive";
+			outputInfos[SEND_OUTPUTS + c]->name = ioLabels[first + c] + " send";
 		}
 	}
 	
@@ -91,19 +92,7 @@ struct Breakout : Module {
 			processCount = 0;
 			
 			// first 1-8 or 9-16?
-			if (params[CHANNEL_PARAM].getValue() > 0.5f) {
-				start = 0;
-				end = 8;
-			}
-			else {
-				start = 8;
-				end = PORT_MAX_CHANNELS;
-			}
-			
-			if (prevStart != start) {
-				prevStart = start;
-				setIoLabels();
-			}
+			start = (params[CHANNEL_PARAM].getValue() > 0.5f ? 0 : 8);
 		}
 
 		if (inputs[POLY_INPUT].isConnected()) {
@@ -112,27 +101,26 @@ struct Breakout : Module {
 			numChannels = inputs[POLY_INPUT].getChannels();
 			outputs[POLY_OUTPUT].setChannels(numChannels);
 
-			if (end > numChannels)
-				end = numChannels;
-
-			int i = 0;
-			for (int c = 0; c < numChannels; c++) {
-				v = inputs[POLY_INPUT].getVoltage(c);
+			// pass the poly signal through 4 channels at a time
+			for (int c = 0; c < numChannels; c += 4)
+				outputs[POLY_OUTPUT].setVoltageSimd(inputs[POLY_INPUT].getVoltageSimd<float_4>(c), c);
+			
+			// send and receive the voltages for the channel range we want
+			for (int i = 0; i < 8; i += 4) {
+				int c = start + i;
+				
+				// channels we don't have are sent as 0V
+				float_4 v = inputs[POLY_INPUT].getVoltageSimd<float_4>(c) & simd::movemaskInverse<float_4>((((1 << numChannels) - 1) >> c) & 0x0f);
 				
-				// if we're in the channel range we want, send and receive the voltages for this channel
-				if (c >= start && c < end) {
-					outputs[SEND_OUTPUTS + i].setVoltage(v);
-					v = inputs[RECEIVE_INPUTS + i].getNormalVoltage(v);
-					i++;
+				float r[4];
+				for (int j = 0; j < 4; j++) {
+					outputs[SEND_OUTPUTS + i + j].setVoltage(v[j]);
+					r[j] = inputs[RECEIVE_INPUTS + i + j].getNormalVoltage(v[j]);
 				}
 				
 				// reconstitute the poly signal
-				outputs[POLY_OUTPUT].setVoltage(v, c);
-			}
-
-			while (i < 8) {
-				outputs[SEND_OUTPUTS + i].setVoltage(0.0f);
-				i++;
+				if (c < numChannels)
+					outputs[POLY_OUTPUT].setVoltageSimd(float_4::load(r), c);
 			}
 		}
 		else {
@@ -147,6 +135,9 @@ struct Breakout : Module {
 struct BreakoutWidget : ModuleWidget {
 	std::string panelName;
 	
+	// the channel range the port labels currently show
+	int labelStart = 0;
+	
 	BreakoutWidget(Breakout *module) {
 		setModule(module);
 		panelName = PANEL_FILE;
@@ -189,6 +180,13 @@ struct BreakoutWidget : ModuleWidget {
 		if (module) {
 			// process any change of theme
 			#include "../themes/step.hpp"
+			
+			// keep the port labels in line with the channel range
+			Breakout *m = (Breakout *)module;
+			if (m->start != labelStart) {
+				labelStart = m->start;
+				m->setIoLabels(labelStart);
+			}
 		}
 		
 		Widget::step();
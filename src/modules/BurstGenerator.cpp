@@ -70,7 +70,7 @@ struct BurstGenerator : Module {
 	#include "../themes/variables.hpp"	
 	
 #ifdef SEQUENCER_EXP_MAX_CHANNELS	
-	SequencerExpanderMessage rightMessages[2][1]; // messages to right module (expander)
+	ExpanderChain<SequencerExpanderMessage> expanderChain;	// expanders driven directly from this module
 #endif	
 	
 	BurstGenerator() {
@@ -98,12 +98,6 @@ struct BurstGenerator : Module {
 		configOutput(DURATION_OUTPUT, "Burst duration");
 		configOutput(END_OUTPUT, "End of burst");
 
-#ifdef SEQUENCER_EXP_MAX_CHANNELS	
-		// expander
-		rightExpander.producerMessage = rightMessages[0];
-		rightExpander.consumerMessage = rightMessages[1];
-#endif			
-
 		// set the theme from the current default value
 		#include "../themes/setDefaultTheme.hpp"
 	}
@@ -138,6 +132,13 @@ struct BurstGenerator : Module {
 		#include "../themes/dataFromJson.hpp"
 	}	
 	
+#ifdef SEQUENCER_EXP_MAX_CHANNELS
+	// any change in the layout means the expander chain needs to be resolved again
+	void onExpanderChange(const ExpanderChangeEvent &e) override {
+		expanderChainGeneration()++;
+	}
+#endif
+
 	void process(const ProcessArgs &args) override {
 
 		// grab the current burst count taking CV into account ans ensuring we don't go below 1
@@ -155,6 +156,9 @@ struct BurstGenerator : Module {
 		// now set it
 		clock.setPitch(rate);
 		
+		// time to step the internal clock by
+		float clockTime = args.sampleTime;
+		
 		// set the trigger input value
 		gpTrig.set(fmaxf(inputs[TRIGGER_INPUT].getVoltage(), params[MANUAL_PARAM].getValue() * 10.0f));
 		bool retrigAllowed = params[RETRIGGER_PARAM].getValue() > 0.5f;
@@ -164,6 +168,9 @@ struct BurstGenerator : Module {
 			if (!bursting || (bursting && retrigAllowed)) {
 				gpClock.reset();
 				clock.reset();
+				
+				// the clock starts from the point the trigger actually crossed the threshold
+				clockTime = gpTrig.edgeDelay() * args.sampleTime;
 		
 				// set the burst to go off
 				startBurst = true;
@@ -176,7 +183,7 @@ struct BurstGenerator : Module {
 		}
 		
 		// tick the internal clock over here as we could have reset the clock above
-		clock.step(args.sampleTime);
+		clock.step(clockTime);
 
 		// get the clock value we want to use (internal or external)
 		float internalClock = 5.0f * clock.sqr();
@@ -248,27 +255,26 @@ struct BurstGenerator : Module {
 		
 #ifdef SEQUENCER_EXP_MAX_CHANNELS	
 		// set up details for the expander
-		if (rightExpander.module) {
-			if (isExpanderModule(rightExpander.module)) {
-				
-				SequencerExpanderMessage *messageToExpander = (SequencerExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
+		if (expanderChain.resolve(this, isSequencerExpander)) {
+			
+			SequencerExpanderMessage *messageToExpander = &expanderChain.message;
 
-				// set any potential expander module's channel number
-				messageToExpander->setAllChannels(0);
+			// set any potential expander module's channel number
+			messageToExpander->setAllChannels(0);
+	
+			// add the channel counters and gates
+			int c = seqBurst ? counter + 1 : 0;
+			for (int i = 0; i < SEQUENCER_EXP_MAX_CHANNELS ; i++) {
+				messageToExpander->counters[i] = c;
+				messageToExpander->clockStates[i] =	gpClock.high();
+				messageToExpander->runningStates[i] = true; // always running - the counter takes care of the not running states 
+			}
 		
-				// add the channel counters and gates
-				int c = seqBurst ? counter + 1 : 0;
-				for (int i = 0; i < SEQUENCER_EXP_MAX_CHANNELS ; i++) {
-					messageToExpander->counters[i] = c;
-					messageToExpander->clockStates[i] =	gpClock.high();
-					messageToExpander->runningStates[i] = true; // always running - the counter takes care of the not running states 
-				}
+			// finally, let all potential expanders know where we came from
+			messageToExpander->masterModule = SEQUENCER_EXP_MASTER_MODULE_BURSTGENERATOR;
 			
-				// finally, let all potential expanders know where we came from
-				messageToExpander->masterModule = SEQUENCER_EXP_MASTER_MODULE_BURSTGENERATOR;
-				
-				rightExpander.module->leftExpander.messageFlipRequested = true;
-			}
+			// drive the expanders directly so the whole chain sees this sample
+			expanderChain.process(args);
 		}
 #endif		
 	}
@@ -218,6 +218,9 @@ struct BurstGenerator64 : Module {
 			clock.setPitch(rate);
 		}
 		
+		// time to step the internal clock by
+		float clockTime = args.sampleTime;
+		
 		// set the trigger input value
 		gpTrig.set(fmaxf(inputs[TRIGGER_INPUT].getVoltage(), params[MANUAL_PARAM].getValue() * 10.0f));
 		
@@ -227,6 +230,9 @@ struct BurstGenerator64 : Module {
 			if (!bursting || (bursting && retriggerParam > 0.5f)) {
 				if (internalClock) {
 					clock.reset();
+					
+					// the clock starts from the point the trigger actually crossed the threshold
+					clockTime = gpTrig.edgeDelay() * args.sampleTime;
 				}
 				
 				gpClock.reset();
@@ -239,7 +245,7 @@ struct BurstGenerator64 : Module {
 		
 		if (internalClock) {
 			// tick the internal clock over here as we could have reset the clock above
-			clock.step(args.sampleTime);
+			clock.step(clockTime);
 			gpClock.set(5.0f * clock.sqr());
 		}
 		else {
@@ -9,6 +9,8 @@
 #define THEME_MODULE_NAME CVSpreader
 #define PANEL_FILE "CVSpreader.svg"
 
+using simd::float_4;
+
 struct CVSpreader : Module {
 	enum ParamIds {
 		BASE_PARAM,
@@ -86,24 +88,36 @@ struct CVSpreader : Module {
 	
 	void process(const ProcessArgs &args) override {
 
-		float base = inputs[BASE_INPUT].getNormalVoltage(10.0f) * params[BASE_PARAM].getValue();
-		float spread = inputs[SPREAD_INPUT].getNormalVoltage(5.0f) * params[SPREAD_PARAM].getValue();
+		// each channel on the base and spread inputs gives its own spread of voltages
+		int n = std::max(std::max(inputs[BASE_INPUT].getChannels(), inputs[SPREAD_INPUT].getChannels()), 1);
+		
+		float baseAmount = params[BASE_PARAM].getValue();
+		float spreadAmount = params[SPREAD_PARAM].getValue();
 		float even = (params[MODE_PARAM].getValue() < 0.5f ? 0.0f : 1.0f);
+		float steps = 9.0f + (even ? 1.0f : 0.0f);
 		
-		float pos = base + spread;
-		float neg = base - spread;
-		float diff = 2.0f * spread;
-		float div = diff / (9.0f + (even ? 1.0f : 0.0f));
-
-		// output F is always the base value
-		outputs[F_OUTPUT].setVoltage(base);
+		for (int i = 0; i < NUM_OUTPUTS; i++)
+			outputs[i].setChannels(n);
 		
-		for (int i = 0; i < 5; i++) {
-			// pos outputs
-			outputs[E_OUTPUT - i].setVoltage(clamp(pos - ((float)i * div), -10.0f, 10.0f));
+		for (int c = 0; c < n; c += 4) {
+			float_4 base = inputs[BASE_INPUT].getNormalPolyVoltageSimd<float_4>(10.0f, c) * baseAmount;
+			float_4 spread = inputs[SPREAD_INPUT].getNormalPolyVoltageSimd<float_4>(5.0f, c) * spreadAmount;
+			
+			float_4 pos = base + spread;
+			float_4 neg = base - spread;
+			float_4 diff = 2.0f * spread;
+			float_4 div = diff / steps;
+
+			// output F is always the base value
+			outputs[F_OUTPUT].setVoltageSimd(base, c);
 			
-			// neg outputs
-			outputs[K_OUTPUT - i].setVoltage(clamp(neg + ((float)i * div), -10.0f, 10.0f));
+			for (int i = 0; i < 5; i++) {
+				// pos outputs
+				outputs[E_OUTPUT - i].setVoltageSimd(simd::clamp(pos - ((float)i * div), -10.0f, 10.0f), c);
+				
+				// neg outputs
+				outputs[K_OUTPUT - i].setVoltageSimd(simd::clamp(neg + ((float)i * div), -10.0f, 10.0f), c);
+			}
 		}
 	}		
 };
@@ -11,6 +11,8 @@
 #define THEME_MODULE_NAME Carousel
 #define PANEL_FILE "Carousel.svg"
 
+using simd::float_4;
+
 struct Carousel : Module {
 	enum ParamIds {
 		ROTATE_UP_PARAM,
@@ -56,6 +58,11 @@ struct Carousel : Module {
 								{ 0, 1, 2, 3, 4, 5, 6, 0, 1, 2, 3, 4, 5, 6, 0, 0}, 
 								{ 0, 1, 2, 3, 4, 5, 6, 7, 0, 1, 2, 3, 4, 5, 6, 7} };
 	
+	// the input feeding each output or -1 for none - only rebuilt when the rotation changes
+	int routing[8] = { -1, -1, -1, -1, -1, -1, -1, -1 };
+	int routingOffset = -1, routingMaxChans = -1;
+	bool routingPassthrough = false;
+	
 	// add the variables we'll use when managing themes
 	#include "../themes/variables.hpp"	
 	
@@ -132,6 +139,22 @@ struct Carousel : Module {
 		inactivePassthrough = false;
 	}
 	
+	// work out which input feeds each output for the current rotation
+	void buildRouting() {
+		for (int i = 0; i < 8; i++) {
+			if (i > maxChans) {
+				// when out of the selected range, just pass the input through to the output
+				routing[i] = inactivePassthrough ? i : -1;
+			}
+			else
+				routing[outputMap[maxChans][offset + i]] = i;
+		}
+		
+		routingOffset = offset;
+		routingMaxChans = maxChans;
+		routingPassthrough = inactivePassthrough;
+	}
+	
 	void process(const ProcessArgs &args) override {
 	
 		if (++processCount > 4) {
@@ -146,38 +169,50 @@ struct Carousel : Module {
 				}
 			}
 			
-			gpUp.set(params[ROTATE_UP_PARAM].getValue() > 0.5f ? 10.0f : inputs[ROTATE_UP_INPUT].getVoltage());
-			gpDn.set(params[ROTATE_DN_PARAM].getValue() > 0.5f ? 10.0f : inputs[ROTATE_DN_INPUT].getVoltage());
-			gpReset.set(params[RESET_PARAM].getValue() > 0.5f ? 10.0f : inputs[RESET_INPUT].getVoltage());
+			processCount = 0;	
+		}
 		
-			if (gpUp.leadingEdge()) {
-				if (--offset < 0)
-					offset = maxChans;
-			}
-			
-			if (gpDn.leadingEdge()) {
-				if (++offset > maxChans)
-					offset = 0;
-			}
-			
-			if (gpReset.leadingEdge())
+		// the rotation is checked every sample so we don't miss any fast clocks
+		gpUp.set(params[ROTATE_UP_PARAM].getValue() > 0.5f ? 10.0f : inputs[ROTATE_UP_INPUT].getVoltage());
+		gpDn.set(params[ROTATE_DN_PARAM].getValue() > 0.5f ? 10.0f : inputs[ROTATE_DN_INPUT].getVoltage());
+		gpReset.set(params[RESET_PARAM].getValue() > 0.5f ? 10.0f : inputs[RESET_INPUT].getVoltage());
+	
+		if (gpUp.leadingEdge()) {
+			if (--offset < 0)
+				offset = maxChans;
+		}
+		
+		if (gpDn.leadingEdge()) {
+			if (++offset > maxChans)
 				offset = 0;
-				
-			processCount = 0;	
 		}
 		
+		if (gpReset.leadingEdge())
+			offset = 0;
+		
 		if (offset > maxChans)
 			 offset = maxChans;
 
 		lights[SELECT_LIGHT + offset].setBrightness(1.0f);
 		
+		if (offset != routingOffset || maxChans != routingMaxChans || inactivePassthrough != routingPassthrough)
+			buildRouting();
+		
+		// gather the outputs from their inputs
 		for (int i = 0; i < 8; i++) {
-			if (i > maxChans) {
-				// when out of the selected range, just pass the input through to the output
-				outputs[CV_OUTPUT + i].setVoltage(inactivePassthrough ? inputs[CV_INPUT + i].getVoltage() : 0.0f);
+			int source = routing[i];
+			
+			if (source < 0) {
+				outputs[CV_OUTPUT + i].setChannels(1);
+				outputs[CV_OUTPUT + i].setVoltage(0.0f);
+			}
+			else {
+				int n = std::max(inputs[CV_INPUT + source].getChannels(), 1);
+				outputs[CV_OUTPUT + i].setChannels(n);
+				
+				for (int c = 0; c < n; c += 4)
+					outputs[CV_OUTPUT + i].setVoltageSimd(inputs[CV_INPUT + source].getVoltageSimd<float_4>(c), c);
 			}
-			else
-				outputs[CV_OUTPUT + outputMap[maxChans][offset +i]].setVoltage(inputs[CV_INPUT + i].getVoltage());
 		}
 		
 		// turn off previous selected input indicator if we need to
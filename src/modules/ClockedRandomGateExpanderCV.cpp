@@ -75,8 +75,14 @@ struct ClockedRandomGateExpanderCV : Module {
 	// add the variables we'll use when managing themes
 	#include "../themes/variables.hpp"
 	
+	// cached expander neighbours
+	ExpanderTopology expanders;
+	
 	ClockedRandomGateExpanderCV() {
 		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
+
+		// expander neighbours
+		expanders.config(this, isClockedRandomGateChainModule, isClockedRandomGateExpander);
 		
 		// from left module (master)
 		leftExpander.producerMessage = leftMessages[0];
@@ -139,6 +145,10 @@ struct ClockedRandomGateExpanderCV : Module {
 		}
 	}
 
+	void onExpanderChange(const ExpanderChangeEvent &e) override {
+		expanders.update();
+	}
+	
 	void process(const ProcessArgs &args) override {
 
 		bool triggered = false;
@@ -149,44 +159,42 @@ struct ClockedRandomGateExpanderCV : Module {
 		
 		// grab the detail from the left hand module if we have one
 		leftModuleAvailable = false;
-		if (leftExpander.module) {
-			if (isExpanderModule(leftExpander.module) || isExpandableModule(leftExpander.module)) {
-					
-				leftModuleAvailable = true;
-				messagesFromMaster = (ClockedRandomGateExpanderMessage *)(leftExpander.consumerMessage);
-
-				singleMode = messagesFromMaster->singleMode;
-				isPolyphonic = messagesFromMaster->isPolyphonic;
-				numPolyChannels = messagesFromMaster->numPolyChannels;
+		if (expanders.left()) {
 				
-				for (int i = 0; i < CRG_EXP_NUM_CHANNELS; i++) {
-					outcomes[i] = messagesFromMaster->gateStates[i];
-					clocks[i] = messagesFromMaster->clockStates[i];
-					triggers[i] = messagesFromMaster->triggerStates[i];
-				}
+			leftModuleAvailable = true;
+			messagesFromMaster = (ClockedRandomGateExpanderMessage *)(leftExpander.consumerMessage);
+
+			singleMode = messagesFromMaster->singleMode;
+			isPolyphonic = messagesFromMaster->isPolyphonic;
+			numPolyChannels = messagesFromMaster->numPolyChannels;
 			
-				if (singleMode)
-					triggered = true;
-				else {
-					// trigger on the positive edge of whatever source we've selected
-					int c = channelID - 1;
-					switch (triggerSource) {
-						case TRIGGER_FROM_CLOCK:
-							triggered = (clocks[c] && !prevClocks[c]);
-							break;
-						case TRIGGER_FROM_GATE:
-							triggered = (outcomes[c] && !prevOutcomes[c]);
-							break;
-						case TRIGGER_FROM_TRIGGER:
-							triggered = (triggers[c] && !prevTriggers[c]);
-							break;
-						case TRIGGER_FROM_GATED_CLOCK:
-							triggered = (outcomes[c] && clocks[c] && !prevClocks[c]);
-							break;
-						case TRIGGER_OFF:
-							triggered = true;
-							break;
-					}
+			for (int i = 0; i < CRG_EXP_NUM_CHANNELS; i++) {
+				outcomes[i] = messagesFromMaster->gateStates[i];
+				clocks[i] = messagesFromMaster->clockStates[i];
+				triggers[i] = messagesFromMaster->triggerStates[i];
+			}
+		
+			if (singleMode)
+				triggered = true;
+			else {
+				// trigger on the positive edge of whatever source we've selected
+				int c = channelID - 1;
+				switch (triggerSource) {
+					case TRIGGER_FROM_CLOCK:
+						triggered = (clocks[c] && !prevClocks[c]);
+						break;
+					case TRIGGER_FROM_GATE:
+						triggered = (outcomes[c] && !prevOutcomes[c]);
+						break;
+					case TRIGGER_FROM_TRIGGER:
+						triggered = (triggers[c] && !prevTriggers[c]);
+						break;
+					case TRIGGER_FROM_GATED_CLOCK:
+						triggered = (outcomes[c] && clocks[c] && !prevClocks[c]);
+						break;
+					case TRIGGER_OFF:
+						triggered = true;
+						break;
 				}
 			}
 		}
@@ -265,28 +273,26 @@ struct ClockedRandomGateExpanderCV : Module {
 		outputs[PULSE_OUTPUT].setVoltage(boolToGate(pulseOut));
 		
 		// finally set up the details for any secondary expander
-		if (rightExpander.module) {
-			if (isExpanderModule(rightExpander.module)) {
+		if (expanders.right()) {
+			
+			ClockedRandomGateExpanderMessage *messageToExpander = (ClockedRandomGateExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
+			
+			// just pass the master module details through
+			if (messagesFromMaster) {
+				
+				messageToExpander->singleMode = singleMode;
+				messageToExpander->isPolyphonic = isPolyphonic;
 				
-				ClockedRandomGateExpanderMessage *messageToExpander = (ClockedRandomGateExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
+				messageToExpander->numPolyChannels = numPolyChannels;
 				
-				// just pass the master module details through
-				if (messagesFromMaster) {
-					
-					messageToExpander->singleMode = singleMode;
-					messageToExpander->isPolyphonic = isPolyphonic;
-					
-					messageToExpander->numPolyChannels = numPolyChannels;
-					
-					for (int i = 0; i < CRG_EXP_NUM_CHANNELS; i++) {
-						messageToExpander->gateStates[i] = outcomes[i];
-						messageToExpander->clockStates[i] =  clocks[i];
-						messageToExpander->triggerStates[i] = triggers[i];
-					}
+				for (int i = 0; i < CRG_EXP_NUM_CHANNELS; i++) {
+					messageToExpander->gateStates[i] = outcomes[i];
+					messageToExpander->clockStates[i] =  clocks[i];
+					messageToExpander->triggerStates[i] = triggers[i];
 				}
-
-				rightExpander.module->leftExpander.messageFlipRequested = true;
 			}
+
+			rightExpander.module->leftExpander.messageFlipRequested = true;
 		}			
 	}
 };
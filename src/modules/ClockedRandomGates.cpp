@@ -55,8 +55,14 @@ struct ClockedRandomGates : Module {
 	#include "../themes/variables.hpp"
 	
 	
+	// cached expander neighbours
+	ExpanderTopology expanders;
+	
 	ClockedRandomGates() {
 		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
+
+		// expander neighbours
+		expanders.config(this, NULL, isClockedRandomGateExpander);
 		
 		configSwitch(MODE_PARAM, 0.0f, 1.0f, 0.0f, "Mode", {"Multi", "Single"});
 		
@@ -114,6 +120,10 @@ struct ClockedRandomGates : Module {
 		#include "../themes/dataFromJson.hpp"
 	}
 	
+	void onExpanderChange(const ExpanderChangeEvent &e) override {
+		expanders.update();
+	}
+	
 	void process(const ProcessArgs &args) override {
 		
 		// determine the mode and polyphony
@@ -253,27 +263,25 @@ struct ClockedRandomGates : Module {
 		}
 		
 		// now set up the expander details
-		if (rightExpander.module) {
-			if (isExpanderModule(rightExpander.module)) {
-				
-				ClockedRandomGateExpanderMessage *messageToExpander = (ClockedRandomGateExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
+		if (expanders.right()) {
+			
+			ClockedRandomGateExpanderMessage *messageToExpander = (ClockedRandomGateExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
 
-				// common details
-				messageToExpander->singleMode = singleMode;
-				messageToExpander->isPolyphonic = isPolyphonic;
-				messageToExpander->numPolyChannels = numPolyChannels;
-	
-				// add the channel specific details
-				for (int i = 0; i <  CRG_EXP_NUM_CHANNELS; i++) {
-					int j = (singleMode || !isPolyphonic ? 0 : i);
-					
-					messageToExpander->gateStates[i] = outcomes[i];
-					messageToExpander->clockStates[i] =	gateClock[j].high();
-					messageToExpander->triggerStates[i] = triggers[i];
-				}
+			// common details
+			messageToExpander->singleMode = singleMode;
+			messageToExpander->isPolyphonic = isPolyphonic;
+			messageToExpander->numPolyChannels = numPolyChannels;
+
+			// add the channel specific details
+			for (int i = 0; i <  CRG_EXP_NUM_CHANNELS; i++) {
+				int j = (singleMode || !isPolyphonic ? 0 : i);
 				
-				rightExpander.module->leftExpander.messageFlipRequested = true;
+				messageToExpander->gateStates[i] = outcomes[i];
+				messageToExpander->clockStates[i] =	gateClock[j].high();
+				messageToExpander->triggerStates[i] = triggers[i];
 			}
+			
+			rightExpander.module->leftExpander.messageFlipRequested = true;
 		}		
 	}
 };
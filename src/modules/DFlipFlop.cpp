@@ -5,59 +5,36 @@
 //----------------------------------------------------------------------------
 #include "../CountModula.hpp"
 #include "../inc/Utility.hpp"
-#include "../inc/GateProcessor.hpp"
+#include "../inc/LatchBank.hpp"
 
 // set the module name for the theme selection functions
 #define THEME_MODULE_NAME SingleDFlipFlop
 #define PANEL_FILE "DFF.svg"
 
-// implements a basic D type flip flop
-struct DLatch {
-	GateProcessor D;
-	GateProcessor C;
-	GateProcessor E;
-
-	bool stateQ = false; 
-	bool stateNQ = true;
-
-	float process (float dIn, float clockIn, float enIn) {
-		D.set(dIn);
-		C.set(clockIn);
-		E.set(enIn);
-
-		if (E.high()) {
-			if (C.leadingEdge()) {
-				stateQ = D.high();
-				stateNQ = !stateQ;
-			}
-		}
+// implements a basic D type flip flop for up to 16 channels
+struct DLatch : LatchBank {
+	GateProcessorSimd D[PORT_MAX_CHANNELS / 4];
+	GateProcessorSimd C[PORT_MAX_CHANNELS / 4];
+	GateProcessorSimd E[PORT_MAX_CHANNELS / 4];
 
-		return boolToGate(stateQ);
-	}
+	void process (Input &dIn, Input &clockIn, Input &enIn, int channels) {
+		uint16_t d = 0, clk = 0, e = 0;
+		
+		for (int c = 0; c < channels; c += 4) {
+			D[c / 4].set(dIn.getPolyVoltageSimd<float_4>(c));
+			C[c / 4].set(clockIn.getPolyVoltageSimd<float_4>(c));
+			E[c / 4].set(enIn.getNormalPolyVoltageSimd<float_4>(10.0f, c));
+			
+			d |= bits(D[c / 4].high(), c);
+			clk |= bits(C[c / 4].leadingEdge(), c);
+			e |= bits(E[c / 4].high(), c);
+		}
 
-	void reset () {
-		stateQ = false; 
-		stateNQ = true;
-	}
-	
-	// gets the current "Q" output
-	float Q() {
-		return boolToGate(stateQ);
-	}
-	
-	// gets the current not Q output
-	float NQ() {
-		return boolToGate(stateNQ);
-	}
-	
-	// gets the current "Q" output light value
-	float QLight() {
-		return boolToLight(stateQ);
-	}
-	
-	// gets the current not Q output light value
-	float NQLight() {
-		return boolToLight(stateNQ);
+		// latch the data on the enabled clock edges
+		clk &= e & channelBits(channels);
+		
+		stateQ = (stateQ & ~clk) | (d & clk);
+		stateNQ = (stateNQ & ~clk) | (~d & clk);
 	}
 };
 
@@ -84,6 +61,9 @@ struct SingleDFlipFlop : Module {
 
 	DLatch flipflop;
 	
+	// polyphonic mode - the flip flop handles as many channels as its inputs provide
+	bool polyphonic = false;
+	
 	// add the variables we'll use when managing themes
 	#include "../themes/variables.hpp"
 		
@@ -103,6 +83,7 @@ struct SingleDFlipFlop : Module {
 	
 	void onReset() override {
 		flipflop.reset();
+		polyphonic = false;
 	}
 
 	json_t *dataToJson() override {
@@ -111,8 +92,14 @@ struct SingleDFlipFlop : Module {
 		json_object_set_new(root, "moduleVersion", json_integer(1));
 		
 		// flip flop states
-		json_object_set_new(root, "QState", json_boolean(flipflop.stateQ));
-		json_object_set_new(root, "NQState", json_boolean(flipflop.stateNQ));
+		json_object_set_new(root, "QState", json_boolean(flipflop.stateQ & 0x01));
+		json_object_set_new(root, "NQState", json_boolean(flipflop.stateNQ & 0x01));
+
+		// polyphonic channel states
+		json_object_set_new(root, "QBits", json_integer(flipflop.stateQ));
+		json_object_set_new(root, "NQBits", json_integer(flipflop.stateNQ));
+		
+		json_object_set_new(root, "polyphonic", json_boolean(polyphonic));
 
 		// add the theme details
 		#include "../themes/dataToJson.hpp"
@@ -127,11 +114,25 @@ struct SingleDFlipFlop : Module {
 		json_t *NQState = json_object_get(root, "NQState");
 	
 		if (QState)
-			flipflop.stateQ = json_boolean_value(QState);
+			flipflop.stateQ = (flipflop.stateQ & 0xfffe) | (json_boolean_value(QState) ? 0x01 : 0x00);
 
 		if (NQState)
-			flipflop.stateNQ =  json_boolean_value(NQState);
+			flipflop.stateNQ = (flipflop.stateNQ & 0xfffe) | (json_boolean_value(NQState) ? 0x01 : 0x00);
 
+		// polyphonic channel states
+		json_t *QBits = json_object_get(root, "QBits");
+		json_t *NQBits = json_object_get(root, "NQBits");
+		
+		if (QBits)
+			flipflop.stateQ = json_integer_value(QBits);
+		
+		if (NQBits)
+			flipflop.stateNQ = json_integer_value(NQBits);
+		
+		json_t *poly = json_object_get(root, "polyphonic");
+		if (poly)
+			polyphonic = json_boolean_value(poly);
+		
 		// grab the theme details
 		#include "../themes/dataFromJson.hpp"		
 	}	
@@ -139,13 +140,21 @@ struct SingleDFlipFlop : Module {
 	
 	void process(const ProcessArgs &args) override {
 
+		// in polyphonic mode the flip flop handles as many channels as there are on its inputs
+		int n = polyphonic ? LatchBank::channels(inputs[D_INPUT], inputs[CLOCK_INPUT], inputs[ENABLE_INPUT]) : 1;
+		
 		//perform the latch logic
-		flipflop.process(inputs[D_INPUT].getVoltage(), inputs[CLOCK_INPUT].getVoltage(), inputs[ENABLE_INPUT].getNormalVoltage(10.0f));
+		flipflop.process(inputs[D_INPUT], inputs[CLOCK_INPUT], inputs[ENABLE_INPUT], n);
 		
 		// set outputs according to latch states
-		outputs[Q_OUTPUT].setVoltage(flipflop.Q());
+		outputs[Q_OUTPUT].setChannels(n);
+		outputs[NQ_OUTPUT].setChannels(n);
+		for (int c = 0; c < n; c += 4) {
+			outputs[Q_OUTPUT].setVoltageSimd(flipflop.Q(c), c);
+			outputs[NQ_OUTPUT].setVoltageSimd(flipflop.NQ(c), c);
+		}
+		
 		lights[Q_LIGHT].setSmoothBrightness(flipflop.QLight(), args.sampleTime);
-		outputs[NQ_OUTPUT].setVoltage(flipflop.NQ());
 		lights[NQ_LIGHT].setSmoothBrightness(flipflop.NQLight(), args.sampleTime);
 	}
 };
@@ -181,6 +190,15 @@ struct SingleDFlipFlopWidget : ModuleWidget {
 	// include the theme menu item struct we'll when we add the theme menu items
 	#include "../themes/ThemeMenuItem.hpp"
 
+	// polyphonic mode menu item
+	struct PolyphonicMenuItem : MenuItem {
+		SingleDFlipFlop *module;
+		
+		void onAction(const event::Action &e) override {
+			module->polyphonic ^= true;
+		}
+	};
+
 	void appendContextMenu(Menu *menu) override {
 		SingleDFlipFlop *module = dynamic_cast<SingleDFlipFlop*>(this->module);
 		assert(module);
@@ -190,6 +208,14 @@ struct SingleDFlipFlopWidget : ModuleWidget {
 		
 		// add the theme menu items
 		#include "../themes/themeMenus.hpp"
+		
+		menu->addChild(new MenuSeparator());
+		menu->addChild(createMenuLabel("Settings"));
+		
+		// add the polyphonic mode menu item
+		PolyphonicMenuItem *polyMenuItem = createMenuItem<PolyphonicMenuItem>("Polyphonic", CHECKMARK(module->polyphonic));
+		polyMenuItem->module = module;
+		menu->addChild(polyMenuItem);
 	}	
 	
 	void step() override {
@@ -112,8 +112,14 @@ struct Euclid : Module {
 	int expanderCounterRests = -1;
 	int expanderCounter = -1;
 	
+	// cached expander neighbours
+	ExpanderTopology expanders;
+	
 	Euclid() {
 		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
+
+		// expander neighbours
+		expanders.config(this, NULL, isEuclidExpander);
 		
 		// length param
 		configParam(LENGTH_PARAM, 1.0f, (float)(EUCLID_SEQ_MAX_LEN), 8.0f, "Length", " Steps");
@@ -260,6 +266,10 @@ struct Euclid : Module {
 		hitsCV = 0.0f;
 	}
 
+	void onExpanderChange(const ExpanderChangeEvent &e) override {
+		expanders.update();
+	}
+	
 	void process(const ProcessArgs &args) override {
 
 		bool processControls = (stepnum == 0);
@@ -440,31 +450,29 @@ struct Euclid : Module {
 			stepnum = 0;
 		
 		// set up details for the expander
-		if (rightExpander.module) {
-			if (isExpanderModule(rightExpander.module)) {
-				
-				EuclidExpanderMessage *messageToExpander = (EuclidExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
+		if (expanders.right()) {
+			
+			EuclidExpanderMessage *messageToExpander = (EuclidExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
 
-				if (gateClock.leadingEdge()) {
-					int maxsteps = std::min(EUCLID_EXP_NUM_STEPS, length);
-					
-					if(++expanderCounter >= maxsteps)
-						expanderCounter = 0;
-					
-					if (gate) {
-						if (++expanderCounterBeats >= maxsteps)
-							expanderCounterBeats = 0;
-					}
-					else {
-						if (++expanderCounterRests >= maxsteps)
-							expanderCounterRests = 0;
-					}
+			if (gateClock.leadingEdge()) {
+				int maxsteps = std::min(EUCLID_EXP_NUM_STEPS, length);
+				
+				if(++expanderCounter >= maxsteps)
+					expanderCounter = 0;
+				
+				if (gate) {
+					if (++expanderCounterBeats >= maxsteps)
+						expanderCounterBeats = 0;
 				}
+				else {
+					if (++expanderCounterRests >= maxsteps)
+						expanderCounterRests = 0;
+				}
+			}
 
-				messageToExpander->set(gate, igate, clockEdge, gateClock.high(), trig, running, expanderCounterBeats, expanderCounterRests, expanderCounter, 1, true);				
+			messageToExpander->set(gate, igate, clockEdge, gateClock.high(), trig, running, expanderCounterBeats, expanderCounterRests, expanderCounter, 1, true);				
 
-				rightExpander.module->leftExpander.messageFlipRequested = true;
-			}
+			rightExpander.module->leftExpander.messageFlipRequested = true;
 		}
 	}
 };
@@ -67,8 +67,14 @@ struct EuclidExpanderCV : Module {
 	// add the variables we'll use when managing themes
 	#include "../themes/variables.hpp"
 	
+	// cached expander neighbours
+	ExpanderTopology expanders;
+	
 	EuclidExpanderCV() {
 		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
+
+		// expander neighbours
+		expanders.config(this, isEuclidChainModule, isEuclidExpander);
 		
 		// from left module (master)
 		leftExpander.producerMessage = leftMessages[0];
@@ -122,6 +128,10 @@ struct EuclidExpanderCV : Module {
 		doRedraw = true;		
 	}	
 	
+	void onExpanderChange(const ExpanderChangeEvent &e) override {
+		expanders.update();
+	}
+	
 	void process(const ProcessArgs &args) override {
 
 		pulseOut = false;
@@ -134,38 +144,36 @@ struct EuclidExpanderCV : Module {
 		// grab the detail from the left hand module if we have one
 		currentChannel = 0;
 		messagesFromMaster = 0;
-		if (leftExpander.module) {
-			if (isExpanderModule(leftExpander.module) || isExpandableModule(leftExpander.module)) {
-					
-				messagesFromMaster = (EuclidExpanderMessage *)(leftExpander.consumerMessage);
-
-				// common ones
-				trig = messagesFromMaster->trig;
-				running = messagesFromMaster->running;
-				clock = messagesFromMaster->clock;
+		if (expanders.left()) {
 				
-				// Determine the output pulse and count to use
-				switch (triggerSource) {
-					case CLOCK_BEATS:
-						pulseOut = messagesFromMaster->beatGate && clock;
-						count = messagesFromMaster->beatCount;
-						break;
-					case CLOCK_RESTS:
-						pulseOut = messagesFromMaster->restGate && clock;
-						count = messagesFromMaster->restCount;
-						break;
-					case CLOCK_CLOCK:
-						pulseOut = clock && running;
-						count = messagesFromMaster->stepCount;
+			messagesFromMaster = (EuclidExpanderMessage *)(leftExpander.consumerMessage);
+
+			// common ones
+			trig = messagesFromMaster->trig;
+			running = messagesFromMaster->running;
+			clock = messagesFromMaster->clock;
+			
+			// Determine the output pulse and count to use
+			switch (triggerSource) {
+				case CLOCK_BEATS:
+					pulseOut = messagesFromMaster->beatGate && clock;
+					count = messagesFromMaster->beatCount;
 					break;
-				}
-				
-				if (userChannel == 0)
-					userChannel = messagesFromMaster->channel;
-				
-				if (messagesFromMaster->hasMaster)
-					currentChannel = userChannel;
+				case CLOCK_RESTS:
+					pulseOut = messagesFromMaster->restGate && clock;
+					count = messagesFromMaster->restCount;
+					break;
+				case CLOCK_CLOCK:
+					pulseOut = clock && running;
+					count = messagesFromMaster->stepCount;
+				break;
 			}
+			
+			if (userChannel == 0)
+				userChannel = messagesFromMaster->channel;
+			
+			if (messagesFromMaster->hasMaster)
+				currentChannel = userChannel;
 		}
 
 		if (currentChannel != prevChannel) {
@@ -206,39 +214,37 @@ struct EuclidExpanderCV : Module {
 		prevCount = count;
 		
 		// finally set up the details for any secondary expander
-		if (rightExpander.module) {
-			if (isExpanderModule(rightExpander.module)) {
-				
-				EuclidExpanderMessage *messageToExpander = (EuclidExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
-				
-				// just pass the master module details through
-				if (messagesFromMaster) {
-						int ch = 0;
-					if (messagesFromMaster->hasMaster) {
-						ch = messagesFromMaster->channel;
-
-						if (++ch > 7)
-							ch = 1;
-					}
-					
-					messageToExpander->set(messagesFromMaster->beatGate,
-											messagesFromMaster->restGate, 
-											messagesFromMaster->clockEdge, 
-											messagesFromMaster->clock, 
-											messagesFromMaster->trig, 
-											messagesFromMaster->running, 
-											messagesFromMaster->beatCount, 
-											messagesFromMaster->restCount, 
-											messagesFromMaster->stepCount, 
-											ch, 
-											messagesFromMaster->hasMaster);
-				}
-				else {
-					messageToExpander->initialise();
+		if (expanders.right()) {
+			
+			EuclidExpanderMessage *messageToExpander = (EuclidExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
+			
+			// just pass the master module details through
+			if (messagesFromMaster) {
+					int ch = 0;
+				if (messagesFromMaster->hasMaster) {
+					ch = messagesFromMaster->channel;
+
+					if (++ch > 7)
+						ch = 1;
 				}
 				
-				rightExpander.module->leftExpander.messageFlipRequested = true;
+				messageToExpander->set(messagesFromMaster->beatGate,
+										messagesFromMaster->restGate, 
+										messagesFromMaster->clockEdge, 
+										messagesFromMaster->clock, 
+										messagesFromMaster->trig, 
+										messagesFromMaster->running, 
+										messagesFromMaster->beatCount, 
+										messagesFromMaster->restCount, 
+										messagesFromMaster->stepCount, 
+										ch, 
+										messagesFromMaster->hasMaster);
 			}
+			else {
+				messageToExpander->initialise();
+			}
+			
+			rightExpander.module->leftExpander.messageFlipRequested = true;
 		}			
 	}
 };
@@ -91,9 +91,15 @@ struct Fade : Module {
 	
 	FadeExpanderMessage rightMessages[2][1]; // messages to right module (expander)
 	
+	// cached expander neighbours
+	ExpanderTopology expanders;
+	
 	Fade() {
 		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
 
+		// expander neighbours
+		expanders.config(this, NULL, isFadeExpander);
+
 		configParam(IN_PARAM, 0.1f, 10.0f, 3.0f, "Fade-in time", " S");
 		configParam(OUT_PARAM, 0.1f, 10.0f, 3.0f, "Fade-out time", " S");
 		configSwitch(FADE_PARAM, 0.0f, 1.0f, 0.0f, "Start/stop", {"Stopped", "Running"});
@@ -156,6 +162,10 @@ struct Fade : Module {
 		#include "../themes/dataFromJson.hpp"
 	}
 		
+	void onExpanderChange(const ExpanderChangeEvent &e) override {
+		expanders.update();
+	}
+	
 	void process(const ProcessArgs &args) override {
 
 		if (++processCount > 8) {
@@ -367,19 +377,17 @@ struct Fade : Module {
 		prevRunning = running;
 		
 		// set up details for the expander
-		if (rightExpander.module) {
-			if (rightExpander.module->model == modelFadeExpander) {
-				
-				FadeExpanderMessage *messageToExpander = (FadeExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
+		if (expanders.right()) {
+			
+			FadeExpanderMessage *messageToExpander = (FadeExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
 
-				// set any potential expander module values
-				messageToExpander->envelope = mute * 10.0f;
-				messageToExpander->run = gate;
-				messageToExpander->fadeIn = (stage == ATTACK_STAGE);
-				messageToExpander->fadeOut = (stage == DECAY_STAGE);
-				
-				rightExpander.module->leftExpander.messageFlipRequested = true;
-			}
+			// set any potential expander module values
+			messageToExpander->envelope = mute * 10.0f;
+			messageToExpander->run = gate;
+			messageToExpander->fadeIn = (stage == ATTACK_STAGE);
+			messageToExpander->fadeOut = (stage == DECAY_STAGE);
+			
+			rightExpander.module->leftExpander.messageFlipRequested = true;
 		}	
 	}
 };
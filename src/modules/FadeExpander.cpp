@@ -47,9 +47,15 @@ struct FadeExpander : Module {
 	FadeExpanderMessage *messagesFromMaster;
 	bool leftModuleAvailable = false; 	
 	
+	// cached expander neighbours
+	ExpanderTopology expanders;
+	
 	FadeExpander() {
 		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
 
+		// expander neighbours
+		expanders.config(this, isFade, NULL);
+
 		configOutput(ENV_OUTPUT, "Envelope");
 		configOutput(INV_OUTPUT, "Inverted envelope");
 		configOutput(GATE_OUTPUT, "Run");
@@ -90,6 +96,10 @@ struct FadeExpander : Module {
 		#include "../themes/dataFromJson.hpp"	
 	}
 		
+	void onExpanderChange(const ExpanderChangeEvent &e) override {
+		expanders.update();
+	}
+	
 	void process(const ProcessArgs &args) override {
 		
 		float envelope = 0.0f;
@@ -98,17 +108,15 @@ struct FadeExpander : Module {
 		bool fadeOut = false;
 	
 		leftModuleAvailable = false;
-		if (leftExpander.module) {
-			if (leftExpander.module->model == modelFade) {
-					
-				leftModuleAvailable = true;
-				messagesFromMaster = (FadeExpanderMessage *)(leftExpander.consumerMessage);				
+		if (expanders.left()) {
 				
-				envelope = messagesFromMaster->envelope; 
-				run = messagesFromMaster->run; 
-				fadeIn = messagesFromMaster->fadeIn; 
-				fadeOut = messagesFromMaster->fadeOut; 
-			}
+			leftModuleAvailable = true;
+			messagesFromMaster = (FadeExpanderMessage *)(leftExpander.consumerMessage);				
+			
+			envelope = messagesFromMaster->envelope; 
+			run = messagesFromMaster->run; 
+			fadeIn = messagesFromMaster->fadeIn; 
+			fadeOut = messagesFromMaster->fadeOut; 
 		}			
 		
 		if (run != prevRun)
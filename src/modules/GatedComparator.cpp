@@ -68,7 +68,7 @@ struct GatedComparator : Module {
 	#include "../themes/variables.hpp"	
 	
 #ifdef SEQUENCER_EXP_MAX_CHANNELS	
-	SequencerExpanderMessage rightMessages[2][1]; // messages to right module (expander)
+	ExpanderChain<SequencerExpanderMessage> expanderChain;	// expanders driven directly from this module
 #endif	
 	
 	GatedComparator() {
@@ -97,12 +97,6 @@ struct GatedComparator : Module {
 			configSwitch(MELODY_PARAMS + s, 0.0f, 1.0f, 0.0f, "Random melody Bit " + bitName, {"Off", "On"});
 			configOutput(Q_OUTPUTS + s, "Bit " + bitName);
 		}
-		
-#ifdef SEQUENCER_EXP_MAX_CHANNELS	
-		// expander
-		rightExpander.producerMessage = rightMessages[0];
-		rightExpander.consumerMessage = rightMessages[1];
-#endif			
 
 		// set the theme from the current default value
 		#include "../themes/setDefaultTheme.hpp"
@@ -147,6 +141,13 @@ struct GatedComparator : Module {
 		processCount = 8;
 	}
 
+#ifdef SEQUENCER_EXP_MAX_CHANNELS
+	// any change in the layout means the expander chain needs to be resolved again
+	void onExpanderChange(const ExpanderChangeEvent &e) override {
+		expanderChainGeneration()++;
+	}
+#endif
+
 	void process(const ProcessArgs &args) override {
 		if (++processCount > 8) {
 			processCount = 0;
@@ -231,27 +232,26 @@ struct GatedComparator : Module {
 		
 #ifdef SEQUENCER_EXP_MAX_CHANNELS	
 		// set up details for the expander
-		if (rightExpander.module) {
-			if (isExpanderModule(rightExpander.module)) {
-				
-				SequencerExpanderMessage *messageToExpander = (SequencerExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
+		if (expanderChain.resolve(this, isSequencerExpander)) {
+			
+			SequencerExpanderMessage *messageToExpander = &expanderChain.message;
 
-				// set any potential expander module's channel number
-				messageToExpander->setAllChannels(0);
-	
-				// add the channel counters and gates
-				int c = (int)(shiftReg & 0xFF);
-				for (int i = 0; i < SEQUENCER_EXP_MAX_CHANNELS ; i++) {
-					messageToExpander->counters[i] = c;
-					messageToExpander->clockStates[i] =	gpClock.high();
-					messageToExpander->runningStates[i] = true; // always running - the counter takes care of the not running states 
-				}
-				
-				// finally, let all potential expanders know where we came from
-				messageToExpander->masterModule = SEQUENCER_EXP_MASTER_MODULE_GATEDCOMPARATOR;
-				
-				rightExpander.module->leftExpander.messageFlipRequested = true;
+			// set any potential expander module's channel number
+			messageToExpander->setAllChannels(0);
+
+			// add the channel counters and gates
+			int c = (int)(shiftReg & 0xFF);
+			for (int i = 0; i < SEQUENCER_EXP_MAX_CHANNELS ; i++) {
+				messageToExpander->counters[i] = c;
+				messageToExpander->clockStates[i] =	gpClock.high();
+				messageToExpander->runningStates[i] = true; // always running - the counter takes care of the not running states 
 			}
+			
+			// finally, let all potential expanders know where we came from
+			messageToExpander->masterModule = SEQUENCER_EXP_MASTER_MODULE_GATEDCOMPARATOR;
+			
+			// drive the expanders directly so the whole chain sees this sample
+			expanderChain.process(args);
 		}
 #endif
 	}
@@ -11,6 +11,8 @@
 #define THEME_MODULE_NAME Megalomaniac
 #define PANEL_FILE "Megalomaniac.svg"
 
+using simd::float_4;
+
 struct Megalomaniac : Module {
 	enum ParamIds {
 		ENUMS(RATECV_PARAMS, 6),
@@ -42,8 +44,19 @@ struct Megalomaniac : Module {
 	
 	short updateCounter;
 	
+	// the current selections and their version
+	int selectedWaveform[6] = {};
+	int selectedRange[6] = {};
+	unsigned int version = megalomaniacNextVersion();
+	
+	// cached expander neighbours
+	ExpanderTopology expanders;
+	
 	Megalomaniac() {
 		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
+
+		// expander neighbours
+		expanders.config(this, NULL, isMegalomaniacControllable);
 		
 		std::string oscName;
 		for (int i = 0; i < 6; i++) {
@@ -86,33 +99,87 @@ struct Megalomaniac : Module {
 		#include "../themes/dataFromJson.hpp"
 	}
 	
+	void onExpanderChange(const ExpanderChangeEvent &e) override {
+		expanders.update();
+		
+		// make sure a new neighbour gets our selections
+		version = megalomaniacNextVersion();
+	}
+	
 	void process(const ProcessArgs &args) override {
 
 		// set up details for the LFO module
 		MegalomaniacControllerMessage *messageToModule;
-		if (rightExpander.module && isControllableModule(rightExpander.module))
+		if (expanders.right())
 			messageToModule = (MegalomaniacControllerMessage*)(rightExpander.module->leftExpander.producerMessage);
 		else
 			messageToModule = &dummyCntrlrMessage;
 		
+		// the polyphonic rate values only need sending for as many channels as we actually have
+		int channels = 1;
+		for (int i = 0; i < 6; i++)
+			channels = std::max(channels, inputs[RATECV_INPUTS + i].getChannels());
+		
+		bool changed = false;
+		float mixLevel[8] = {};
+		float fmValue[8] = {};
 		for (int i = 0; i < 6; i++) {
 			// wave select 0-2 = off, 2 -4 = Sin etc.
+			int wave = 0;
 			if (inputs[WAVECV_INPUTS + i].isConnected())
-				messageToModule->selectedWaveform[i] = 1 + (int)(clamp(inputs[WAVECV_INPUTS + i].getVoltage()/2.0f, 0.0f, 4.0f));
-			else
-				messageToModule->selectedWaveform[i] = 0;
+				wave = 1 + (int)(clamp(inputs[WAVECV_INPUTS + i].getVoltage()/2.0f, 0.0f, 4.0f));
 				
 			// range select 0-2 = U, 2-4 = L, 4-6 = H
+			int range = 0;
 			if (inputs[RANGECV_INPUTS +i].isConnected())
-				messageToModule->selectedRange[i] = 1 + (int)(clamp(inputs[RANGECV_INPUTS + i].getVoltage()/2.0f, 0.0f, 2.0f));
-			else
-				messageToModule->selectedRange[i] = 0;
+				range = 1 + (int)(clamp(inputs[RANGECV_INPUTS + i].getVoltage()/2.0f, 0.0f, 2.0f));
+			
+			if (wave != selectedWaveform[i] || range != selectedRange[i]) {
+				selectedWaveform[i] = wave;
+				selectedRange[i] = range;
+				changed = true;
+			}
 			
 			// mix levels
-			messageToModule->mixLevel[i] = clamp(inputs[MIXCV_INPUTS + i].getNormalVoltage(10.0), 0.0f, 10.0f) / 10.0f * params[MIX_PARAMS + i].getValue();
+			mixLevel[i] = clamp(inputs[MIXCV_INPUTS + i].getNormalVoltage(10.0), 0.0f, 10.0f) / 10.0f * params[MIX_PARAMS + i].getValue();
 			
 			// rate values
-			messageToModule->fmValue[i] = clamp(inputs[RATECV_INPUTS + i].getVoltage(), -12.0f, 12.0f) * params[RATECV_PARAMS + i].getValue();
+			fmValue[i] = clamp(inputs[RATECV_INPUTS + i].getVoltage(), -12.0f, 12.0f) * params[RATECV_PARAMS + i].getValue();
+			
+			// polyphonic rate values - a monophonic input applies to all channels. with only 1 channel the LFO uses the mono values
+			// and there's no point filling in the dummy message
+			if (channels > 1 && expanders.right()) {
+				int n = inputs[RATECV_INPUTS + i].getChannels();
+				for (int c = 0; c < channels; c += 4) {
+					float_4 v = 0.0f;
+					if (n == 1)
+						v = fmValue[i];
+					else if (c < n)
+						v = simd::clamp(inputs[RATECV_INPUTS + i].getVoltageSimd<float_4>(c), -12.0f, 12.0f) * params[RATECV_PARAMS + i].getValue();
+					
+					messageToModule->fmValues[i][c / 4] = v;
+				}
+			}
+		}
+		
+		messageToModule->channels = channels;
+		
+		for (int i = 0; i < 2; i++) {
+			messageToModule->mixLevel[i] = float_4::load(&mixLevel[i * 4]);
+			messageToModule->fmValue[i] = float_4::load(&fmValue[i * 4]);
+		}
+		
+		// the selections only go across when they've changed. each message buffer is brought up to date in turn
+		if (changed)
+			version = megalomaniacNextVersion();
+		
+		if (messageToModule->version != version) {
+			for (int i = 0; i < 6; i++) {
+				messageToModule->selectedWaveform[i] = selectedWaveform[i];
+				messageToModule->selectedRange[i] = selectedRange[i];
+			}
+			
+			messageToModule->version = version;
 		}
 
 		// no need to update the lights every sample
@@ -120,16 +187,16 @@ struct Megalomaniac : Module {
 			updateCounter = 0;
 			for (int i = 0; i < 6; i ++) {
 				for (int j = 0; j < 5; j ++) {
-					lights[WAVE_LIGHTS + (i * 5) + j].setBrightness(boolToLight(messageToModule->selectedWaveform[i] == j + 1 ));
+					lights[WAVE_LIGHTS + (i * 5) + j].setBrightness(boolToLight(selectedWaveform[i] == j + 1 ));
 					
 					if (j < 3)
-						lights[RANGE_LIGHTS + (i * 3) + j].setBrightness(boolToLight(messageToModule->selectedRange[i] == j + 1 ));
+						lights[RANGE_LIGHTS + (i * 3) + j].setBrightness(boolToLight(selectedRange[i] == j + 1 ));
 				}
 			}
 		}
 		
 		// set up details for the expander
-		if (rightExpander.module && isControllableModule(rightExpander.module))
+		if (expanders.right())
 			rightExpander.module->leftExpander.messageFlipRequested = true;		
 	}
 };
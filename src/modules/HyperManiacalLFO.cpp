@@ -15,6 +15,13 @@
 
 using simd::float_4;
 
+// waveform demand flags - only the waveforms that are actually used get generated
+#define LFO_WAVE_SIN 0x01
+#define LFO_WAVE_SAW 0x02
+#define LFO_WAVE_TRI 0x04
+#define LFO_WAVE_SQR 0x08
+#define LFO_WAVE_ALL 0x0F
+
 template <typename T>
 T sin2pi_pade_05_5_4(T x) {
 	x -= 0.5f;
@@ -29,6 +36,9 @@ struct VoltageControlledOscillator {
 	
 	// For optimizing in serial code
 	int channels = 0;
+	
+	// the waveforms to generate, the others just hold their last values
+	int waves = LFO_WAVE_ALL;
 
 	T phase = 0.f;
 	T freq;
@@ -51,8 +61,9 @@ struct VoltageControlledOscillator {
 		phase = simd::clamp(newPhase, -1.0f, 1.0f);
 	}
 	
+	// fast exp2 approximation - offset into the range the approximation is good for and scaled back down again
 	void setPitch(T pitch) {
-		freq = dsp::approxExp2_taylor5(pitch + 30) / 1073741824;
+		freq = dsp::approxExp2_taylor5(pitch + 30) * (1.0f / 1073741824.0f);
 	}
 
 	void setPulseWidth(T pulseWidth) {
@@ -71,64 +82,76 @@ struct VoltageControlledOscillator {
 		// Wrap phase
 		phase -= simd::floor(phase);
 
-		// Jump sqr when crossing 0, or 1 if backwards
-		T wrapPhase = (syncDirection == -1.f) & 1.f;
-		T wrapCrossing = (wrapPhase - (phase - deltaPhase)) / deltaPhase;
-		int wrapMask = simd::movemask((0 < wrapCrossing) & (wrapCrossing <= 1.f));
-		if (wrapMask) {
-			for (int i = 0; i < channels; i++) {
-				if (wrapMask & (1 << i)) {
-					T mask = simd::movemaskInverse<T>(1 << i);
-					float p = wrapCrossing[i] - 1.f;
-					T x = mask & (2.f * syncDirection);
-					sqrMinBlep.insertDiscontinuity(p, x);
+		if (waves & LFO_WAVE_SQR) {
+			// Jump sqr when crossing 0, or 1 if backwards
+			T wrapPhase = (syncDirection == -1.f) & 1.f;
+			T wrapCrossing = (wrapPhase - (phase - deltaPhase)) / deltaPhase;
+			int wrapMask = simd::movemask((0 < wrapCrossing) & (wrapCrossing <= 1.f));
+			if (wrapMask) {
+				for (int i = 0; i < channels; i++) {
+					if (wrapMask & (1 << i)) {
+						T mask = simd::movemaskInverse<T>(1 << i);
+						float p = wrapCrossing[i] - 1.f;
+						T x = mask & (2.f * syncDirection);
+						sqrMinBlep.insertDiscontinuity(p, x);
+					}
 				}
 			}
-		}
 
-		// Jump sqr when crossing `pulseWidth`
-		T pulseCrossing = (pulseWidth - (phase - deltaPhase)) / deltaPhase;
-		int pulseMask = simd::movemask((0 < pulseCrossing) & (pulseCrossing <= 1.f));
-		if (pulseMask) {
-			for (int i = 0; i < channels; i++) {
-				if (pulseMask & (1 << i)) {
-					T mask = simd::movemaskInverse<T>(1 << i);
-					float p = pulseCrossing[i] - 1.f;
-					T x = mask & (-2.f * syncDirection);
-					sqrMinBlep.insertDiscontinuity(p, x);
+			// Jump sqr when crossing `pulseWidth`
+			T pulseCrossing = (pulseWidth - (phase - deltaPhase)) / deltaPhase;
+			int pulseMask = simd::movemask((0 < pulseCrossing) & (pulseCrossing <= 1.f));
+			if (pulseMask) {
+				for (int i = 0; i < channels; i++) {
+					if (pulseMask & (1 << i)) {
+						T mask = simd::movemaskInverse<T>(1 << i);
+						float p = pulseCrossing[i] - 1.f;
+						T x = mask & (-2.f * syncDirection);
+						sqrMinBlep.insertDiscontinuity(p, x);
+					}
 				}
 			}
 		}
 
-		// Jump saw when crossing 0.5
-		T halfCrossing = (0.5f - (phase - deltaPhase)) / deltaPhase;
-		int halfMask = simd::movemask((0 < halfCrossing) & (halfCrossing <= 1.f));
-		if (halfMask) {
-			for (int i = 0; i < channels; i++) {
-				if (halfMask & (1 << i)) {
-					T mask = simd::movemaskInverse<T>(1 << i);
-					float p = halfCrossing[i] - 1.f;
-					T x = mask & (-2.f * syncDirection);
-					sawMinBlep.insertDiscontinuity(p, x);
+		if (waves & LFO_WAVE_SAW) {
+			// Jump saw when crossing 0.5
+			T halfCrossing = (0.5f - (phase - deltaPhase)) / deltaPhase;
+			int halfMask = simd::movemask((0 < halfCrossing) & (halfCrossing <= 1.f));
+			if (halfMask) {
+				for (int i = 0; i < channels; i++) {
+					if (halfMask & (1 << i)) {
+						T mask = simd::movemaskInverse<T>(1 << i);
+						float p = halfCrossing[i] - 1.f;
+						T x = mask & (-2.f * syncDirection);
+						sawMinBlep.insertDiscontinuity(p, x);
+					}
 				}
 			}
 		}
 
 		// Square
-		sqrValue = sqr(phase);
-		sqrValue += sqrMinBlep.process();
+		if (waves & LFO_WAVE_SQR) {
+			sqrValue = sqr(phase);
+			sqrValue += sqrMinBlep.process();
+		}
 
 		// Saw
-		sawValue = saw(phase);
-		sawValue += sawMinBlep.process();
+		if (waves & LFO_WAVE_SAW) {
+			sawValue = saw(phase);
+			sawValue += sawMinBlep.process();
+		}
 
 		// Tri
-		triValue = tri(phase);
-		triValue += triMinBlep.process();
+		if (waves & LFO_WAVE_TRI) {
+			triValue = tri(phase);
+			triValue += triMinBlep.process();
+		}
 
 		// Sin
-		sinValue = sin(phase);
-		sinValue += sinMinBlep.process();
+		if (waves & LFO_WAVE_SIN) {
+			sinValue = sin(phase);
+			sinValue += sinMinBlep.process();
+		}
 	}
 
 	T sin(T phase) {
@@ -225,8 +248,27 @@ struct HyperManiacalLFO : Module {
 	
 	LagProcessor slew;
 	
+	// polyphonic mode - a bank of 6 LFOs per channel with the channels for each LFO grouped 4 at a time
+	bool polyphonic = false;
+	VoltageControlledOscillator<8, 8, float_4> polyLfos[6][PORT_MAX_CHANNELS / 4];
+	LagProcessor polySlew[PORT_MAX_CHANNELS];
+	
+	// cached expander neighbours
+	ExpanderTopology expanders;
+	
+	// waveform and range selections - only worked out again when the controller or panel may have changed them
+	int wave[6] = {};
+	int waves[2] = {};
+	float_4 rangeOffsets[2] = {};
+	unsigned int controllerVersion = 0;
+	bool selectionsChanged = true;
+	int processCount = 8;
+	
 	HyperManiacalLFO() {
 		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
+
+		// expander neighbours
+		expanders.config(this, isMegalomaniacController, isHyperManiacalLFOExpander);
 		
 		configParam(GLIDE_SH_PARAM, 0.0f, 1.0f, 1.0f, "Glide shape");
 		configParam(GLIDE_PARAM, 0.0f, 1.0f, 0.0f, "Glide rate");
@@ -245,11 +287,7 @@ struct HyperManiacalLFO : Module {
 		configOutput(LFO_OUTPUT, "Maniacal LFO");
 		configOutput(INV_OUTPUT, "Inverted maniacal LFO");
 	
-		for (int i = 0; i < 2; i++) {		
-			float r[] = {random::uniform(), random::uniform(), random::uniform(), random::uniform()};
-			float_4 newPhase = float_4::load(&r[0]);
-			lfos[i].setPhase(newPhase);
-		}
+		randomisePhases();
 		
 		// expander
 		rightExpander.producerMessage = rightMessages[0];
@@ -263,21 +301,38 @@ struct HyperManiacalLFO : Module {
 		#include "../themes/setDefaultTheme.hpp"
 	}
 
-	void onReset() override {
+	void randomisePhases() {
 		for (int i = 0; i < 2; i++) {		
-
 			float r[] = {random::uniform(), random::uniform(), random::uniform(), random::uniform()};
 			float_4 newPhase = float_4::load(&r[0]);
 			lfos[i].setPhase(newPhase);
 		}
 		
+		for (int i = 0; i < 6; i++) {
+			for (int g = 0; g < PORT_MAX_CHANNELS / 4; g++) {
+				float r[] = {random::uniform(), random::uniform(), random::uniform(), random::uniform()};
+				float_4 newPhase = float_4::load(&r[0]);
+				polyLfos[i][g].setPhase(newPhase);
+			}
+		}
+	}
+	
+	void onReset() override {
+		randomisePhases();
+		
 		slew.reset();
+		
+		for (int c = 0; c < PORT_MAX_CHANNELS; c++)
+			polySlew[c].reset();
+		
+		polyphonic = false;
 	}
 
 	json_t *dataToJson() override {
 		json_t *root = json_object();
 		
 		json_object_set_new(root, "moduleVersion", json_integer(1));
+		json_object_set_new(root, "polyphonic", json_boolean(polyphonic));
 			
 		// add the theme details
 		#include "../themes/dataToJson.hpp"		
@@ -286,31 +341,35 @@ struct HyperManiacalLFO : Module {
 	}
 
 	void dataFromJson(json_t* root) override {
+		
+		json_t *poly = json_object_get(root, "polyphonic");
+		if (poly)
+			polyphonic = json_boolean_value(poly);
+		
 		// grab the theme details
 		#include "../themes/dataFromJson.hpp"
 	}
 	
-	void process(const ProcessArgs &args) override {
-
-		// set up details for the expander
-		HyperManiacalLFOExpanderMessage *messageToExpander;
-		if (rightExpander.module && isExpanderModule(rightExpander.module))
-			messageToExpander = (HyperManiacalLFOExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
-		else
-			messageToExpander = &dummyExpndrMessage;
-
-		messageToExpander->unipolar = params[MODE_PARAM].getValue() < 0.5f;
-
-		// grab details from the contoller if present
-		MegalomaniacControllerMessage *messageFromController;
-		if (leftExpander.module && isControllerModule(leftExpander.module))
-			messageFromController = (MegalomaniacControllerMessage*)(leftExpander.consumerMessage);
-		else
-			messageFromController = &dummyCntrlrMessage;
-
-		float osc_pitch[8] = {};
+	void onExpanderChange(const ExpanderChangeEvent &e) override {
+		expanders.update();
+		selectionsChanged = true;
+	}
+	
+	// work out the waveform and range selections along with the waveforms each group of oscillators needs to generate
+	void updateSelections(MegalomaniacControllerMessage *messageFromController, bool allWaves) {
+		waves[0] = waves[1] = 0;
+		
 		for (int i = 0; i < 6; i++) {
-			osc_pitch[i] = params[FREQ_PARAMS + i].getValue() + messageFromController->fmValue[i];
+			// determine the waveform selection
+			wave[i] = messageFromController->selectedWaveform[i] - 1;
+			if (wave[i] < 0)
+				wave[i] = (int)(params[WAVE_SEL_PARAMS + i].getValue());
+			
+			// build up the demand for each group of 4 oscillators
+			if (allWaves)
+				waves[i / 4] = LFO_WAVE_ALL;
+			else if (wave[i] > 0)
+				waves[i / 4] |= (1 << (wave[i] - 1));
 			
 			// determine the range - need to reverse the order from the controller
 			int range = 3 - messageFromController->selectedRange[i];
@@ -319,85 +378,217 @@ struct HyperManiacalLFO : Module {
 			
 			switch (range) {
 				case 2: // high 45 Hz - 11.6kHz
-					osc_pitch[i] += 5.5;
+					rangeOffsets[i / 4][i % 4] = 5.5f;
 					break;
 				case 0: // ultra low 0.002 Hz - 0.5 Hz (2-512 second period)
-					osc_pitch[i] -= 9.0;
+					rangeOffsets[i / 4][i % 4] = -9.0f;
 					break;
 				default:	// low 0.5 Hz - 116 Hz (0.07 - 2 second period)
-					osc_pitch[i] -= 1.0;
+					rangeOffsets[i / 4][i % 4] = -1.0f;
 					break;
 			}
 		}
 		
-		for (int i = 0; i < 6; i+=4) {
-			auto* lfo = &lfos[i / 4];
+		controllerVersion = messageFromController->version;
+		selectionsChanged = false;
+	}
+	
+	void processPolyphonic(const ProcessArgs &args, float_4 *osc_pitch, float *mixLevel, bool allWaves, HyperManiacalLFOExpanderMessage *messageToExpander, MegalomaniacControllerMessage *messageFromController) {
+		int channels = clamp(messageFromController->channels, 1, PORT_MAX_CHANNELS);
+		int groups = (channels + 3) / 4;
+
+		float lvl = params[LEVEL_PARAM].getValue();
+		float_4 oscValues[PORT_MAX_CHANNELS / 4] = {};
+		
+		for (int i = 0; i < 6; i++) {
+			// each channel only needs the selected waveform, the first one also feeds the expander
+			int waves = (wave[i] > 0) ? (1 << (wave[i] - 1)) : 0;
+			float mix = lvl * mixLevel[i];
+			float_4 pitch = osc_pitch[i / 4][i % 4];
 			
-			lfo->channels = std::min(6 - i, 4);
-			lfo->unipolar = messageToExpander->unipolar;
+			for (int g = 0; g < groups; g++) {
+				auto* lfo = &polyLfos[i][g];
+				
+				lfo->channels = std::min(channels - (g * 4), 4);
+				lfo->unipolar = messageToExpander->unipolar;
+				lfo->waves = (allWaves && g == 0) ? LFO_WAVE_ALL : waves;
+				
+				// the controller only sends the polyphonic rate values when there's more than 1 channel
+				if (channels > 1)
+					lfo->setPitch(pitch + messageFromController->fmValues[i][g]);
+				else
+					lfo->setPitch(pitch + messageFromController->fmValue[i / 4][i % 4]);
+				lfo->process(args.sampleTime);
+				
+				switch (wave[i]) {
+					case 1:
+						oscValues[g] += (lfo->sin() * mix);
+						break;
+					case 2:
+						oscValues[g] += (lfo->saw() * mix);
+						break;
+					case 3:
+						oscValues[g] += (lfo->tri() * mix);
+						break;
+					case 4:
+						oscValues[g] += (lfo->sqr() * mix);
+						break;
+					default:
+						break;
+				}
+			}
 			
-			float_4 pitch = float_4::load(&osc_pitch[i]);
-
-			lfo->setPitch(pitch);
-			lfo->process(args.sampleTime);
-	
-			lfo->sin().store(&(messageToExpander->sin[i]));
-			lfo->saw().store(&(messageToExpander->saw[i]));
-			lfo->tri().store(&(messageToExpander->tri[i]));
-			lfo->sqr().store(&(messageToExpander->sqr[i]));
+			// the expander and lights follow the first channel
+			auto* lfo = &polyLfos[i][0];
+			if (allWaves) {
+				messageToExpander->sin[i] = lfo->sin()[0];
+				messageToExpander->saw[i] = lfo->saw()[0];
+				messageToExpander->tri[i] = lfo->tri()[0];
+				messageToExpander->sqr[i] = lfo->sqr()[0];
+			}
 			
-			lfo->light().store(&(messageToExpander->lig[i]));
+			messageToExpander->lig[i] = lfo->light()[0];
+			messageToExpander->frq[i] = lfo->freq[0];
 			
-			lfo->freq.store(&(messageToExpander->frq[i]));
+			lights[LFO_LIGHTS + i].setSmoothBrightness(messageToExpander->lig[i], args.sampleTime);
 		}
 		
-		float lvl = params[LEVEL_PARAM].getValue();
-		float oscValues = 0.0f;
+		float glide = params[GLIDE_PARAM].getValue();
+		float shape = params[GLIDE_SH_PARAM].getValue();
+		
+		outputs[LFO_OUTPUT].setChannels(channels);
+		outputs[INV_OUTPUT].setChannels(channels);
+		
+		for (int g = 0; g < groups; g++) {
+			if (glide > 0.0f) {
+				for (int c = 0; c < std::min(channels - (g * 4), 4); c++)
+					oscValues[g][c] = polySlew[(g * 4) + c].process(oscValues[g][c], shape, glide, glide, args.sampleTime);
+			}
+			
+			// TODO: saturation rather than clipping
+			oscValues[g] = simd::clamp(oscValues[g], (messageToExpander->unipolar ? 0.0f : -11.2f), 11.2f);
+			
+			outputs[LFO_OUTPUT].setVoltageSimd(oscValues[g], g * 4);
+			outputs[INV_OUTPUT].setVoltageSimd(-oscValues[g], g * 4);
+		}
+	}
+	
+	void process(const ProcessArgs &args) override {
 
-		for (int i = 0; i < 6; i++) {
+		// set up details for the expander
+		HyperManiacalLFOExpanderMessage *messageToExpander;
+		if (expanders.right())
+			messageToExpander = (HyperManiacalLFOExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
+		else
+			messageToExpander = &dummyExpndrMessage;
+
+		messageToExpander->unipolar = params[MODE_PARAM].getValue() < 0.5f;
+
+		// grab details from the contoller if present
+		MegalomaniacControllerMessage *messageFromController;
+		if (expanders.left())
+			messageFromController = (MegalomaniacControllerMessage*)(leftExpander.consumerMessage);
+		else
+			messageFromController = &dummyCntrlrMessage;
+
+		// the expander shows every waveform so we need the lot if we have one
+		bool allWaves = expanders.right();
+		
+		// the waveform and range selections only need working out again when they may have changed
+		if (++processCount > 8 || selectionsChanged || messageFromController->version != controllerVersion) {
+			processCount = 0;
+			updateSelections(messageFromController, allWaves);
+		}
+		
+		float freq[8] = {};
+		for (int i = 0; i < 6; i++)
+			freq[i] = params[FREQ_PARAMS + i].getValue();
+		
+		// base pitch for each group of 4 oscillators
+		float_4 osc_pitch[2];
+		for (int i = 0; i < 2; i++)
+			osc_pitch[i] = float_4::load(&freq[i * 4]) + rangeOffsets[i];
+		
+		// if we have a controller, these are the mix levels
+		float mixLevel[8];
+		messageFromController->mixLevel[0].store(&mixLevel[0]);
+		messageFromController->mixLevel[1].store(&mixLevel[4]);
+		
+		if (polyphonic)
+			processPolyphonic(args, osc_pitch, mixLevel, allWaves, messageToExpander, messageFromController);
+		else {
+			for (int i = 0; i < 6; i+=4) {
+				auto* lfo = &lfos[i / 4];
 			
-			// determine the waveform selection
-			int wave = messageFromController->selectedWaveform[i] - 1;
-			if (wave < 0)
-				wave = (int)(params[WAVE_SEL_PARAMS + i].getValue());
+				lfo->channels = std::min(6 - i, 4);
+				lfo->unipolar = messageToExpander->unipolar;
+				lfo->waves = waves[i / 4];
 			
-			// if we have a controller, apply the mix levels
-			float mix = messageFromController-> mixLevel[i];
-			switch (wave) {
-				case 1:
-					oscValues += (messageToExpander->sin[i] * lvl * mix);
-					break;
-				case 2:
-					oscValues += (messageToExpander->saw[i] * lvl * mix);
-					break;
-				case 3:
-					oscValues += (messageToExpander->tri[i] * lvl * mix);
-					break;
-				case 4:
-					oscValues += (messageToExpander->sqr[i] * lvl * mix);
-					break;
-				default:
-					break;
+				// the controller rate CV is streamed 4 oscillators at a time
+				float_4 pitch = osc_pitch[i / 4] + messageFromController->fmValue[i / 4];
+
+				lfo->setPitch(pitch);
+				lfo->process(args.sampleTime);
+	
+				if (lfo->waves & LFO_WAVE_SIN)
+					lfo->sin().store(&(messageToExpander->sin[i]));
+				if (lfo->waves & LFO_WAVE_SAW)
+					lfo->saw().store(&(messageToExpander->saw[i]));
+				if (lfo->waves & LFO_WAVE_TRI)
+					lfo->tri().store(&(messageToExpander->tri[i]));
+				if (lfo->waves & LFO_WAVE_SQR)
+					lfo->sqr().store(&(messageToExpander->sqr[i]));
+			
+				lfo->light().store(&(messageToExpander->lig[i]));
+			
+				lfo->freq.store(&(messageToExpander->frq[i]));
 			}
+		
+			float lvl = params[LEVEL_PARAM].getValue();
+			float oscValues = 0.0f;
+
+			for (int i = 0; i < 6; i++) {
 			
+				// if we have a controller, apply the mix levels
+				float mix = mixLevel[i];
+				switch (wave[i]) {
+					case 1:
+						oscValues += (messageToExpander->sin[i] * lvl * mix);
+						break;
+					case 2:
+						oscValues += (messageToExpander->saw[i] * lvl * mix);
+						break;
+					case 3:
+						oscValues += (messageToExpander->tri[i] * lvl * mix);
+						break;
+					case 4:
+						oscValues += (messageToExpander->sqr[i] * lvl * mix);
+						break;
+					default:
+						break;
+				}
 			
-			lights[LFO_LIGHTS + i].setSmoothBrightness(messageToExpander->lig[i], args.sampleTime);
-		}
+			
+				lights[LFO_LIGHTS + i].setSmoothBrightness(messageToExpander->lig[i], args.sampleTime);
+			}
 
-		float g = params[GLIDE_PARAM].getValue();
-		if (g > 0.0f) {
-			float s = params[GLIDE_SH_PARAM].getValue();
-			oscValues = slew.process(oscValues, s, g, g, args.sampleTime);
-		}
+			float g = params[GLIDE_PARAM].getValue();
+			if (g > 0.0f) {
+				float s = params[GLIDE_SH_PARAM].getValue();
+				oscValues = slew.process(oscValues, s, g, g, args.sampleTime);
+			}
 
-		// TODO: saturation rather than clipping
-		oscValues = clamp(oscValues, (messageToExpander->unipolar ? 0.0f : -11.2f), 11.2f);
+			// TODO: saturation rather than clipping
+			oscValues = clamp(oscValues, (messageToExpander->unipolar ? 0.0f : -11.2f), 11.2f);
 		
-		outputs[LFO_OUTPUT].setVoltage(oscValues);
-		outputs[INV_OUTPUT].setVoltage(-oscValues);
+			outputs[LFO_OUTPUT].setChannels(1);
+			outputs[INV_OUTPUT].setChannels(1);
+			outputs[LFO_OUTPUT].setVoltage(oscValues);
+			outputs[INV_OUTPUT].setVoltage(-oscValues);
+		}
 		
 		// set up details for the expander
-		if (rightExpander.module && isExpanderModule(rightExpander.module))
+		if (expanders.right())
 			rightExpander.module->leftExpander.messageFlipRequested = true;
 	}
 };
@@ -499,6 +690,15 @@ struct HyperManiacalLFOWidget : ModuleWidget {
 		}
 	};	
 
+	// polyphonic mode menu item
+	struct PolyphonicMenuItem : MenuItem {
+		HyperManiacalLFO *module;
+		
+		void onAction(const event::Action &e) override {
+			module->polyphonic ^= true;
+		}
+	};
+	
 	void appendContextMenu(Menu *menu) override {
 		HyperManiacalLFO *module = dynamic_cast<HyperManiacalLFO*>(this->module);
 		assert(module);
@@ -515,6 +715,13 @@ struct HyperManiacalLFOWidget : ModuleWidget {
 		expMenuItem->position = box.pos;
 		menu->addChild(expMenuItem);		
 		
+		menu->addChild(new MenuSeparator());
+		menu->addChild(createMenuLabel("Settings"));
+		
+		// add the polyphonic mode menu item
+		PolyphonicMenuItem *polyMenuItem = createMenuItem<PolyphonicMenuItem>("Polyphonic", CHECKMARK(module->polyphonic));
+		polyMenuItem->module = module;
+		menu->addChild(polyMenuItem);
 	}	
 	
 	void step() override {
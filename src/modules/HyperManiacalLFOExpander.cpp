@@ -48,8 +48,14 @@ struct HyperManiacalLFOExpander : Module {
 	HyperManiacalLFOExpanderMessage leftMessages[2][1];	// messages from left module (master)
 	HyperManiacalLFOExpanderMessage *messagesFromMaster;
 	
+	// cached expander neighbours
+	ExpanderTopology expanders;
+	
 	HyperManiacalLFOExpander() {
 		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
+
+		// expander neighbours
+		expanders.config(this, isHyperManiacalLFO, NULL);
 		
 		std::string oscName;
 		for (int i=0; i < 6; i++) {
@@ -96,9 +102,13 @@ struct HyperManiacalLFOExpander : Module {
 			offsetMode = json_integer_value(o);
 	}
 	
+	void onExpanderChange(const ExpanderChangeEvent &e) override {
+		expanders.update();
+	}
+	
 	void process(const ProcessArgs &args) override {
 
-		if (leftExpander.module && isExpandableModule(leftExpander.module)) {
+		if (expanders.left()) {
 			messagesFromMaster = (HyperManiacalLFOExpanderMessage *)(leftExpander.consumerMessage);
 
 			float offset;
@@ -10,6 +10,13 @@
 #define THEME_MODULE_NAME Manifold
 #define PANEL_FILE "Manifold.svg"
 
+// channel replication modes
+#define MANIFOLD_BLOCK 0	// input channels are a multiple of 4 - straight block copies
+#define MANIFOLD_PATTERN 1	// input channels divide into 4 - build one block and repeat it
+#define MANIFOLD_GATHER 2	// anything else - use the gather index table
+
+using simd::float_4;
+
 struct Manifold : Module {
 	enum ParamIds {
 		ENUMS(CHANNELS_PARAM, 2),
@@ -30,6 +37,12 @@ struct Manifold : Module {
 	// add the variables we'll use when managing themes
 	#include "../themes/variables.hpp"
 	
+	// channel routing - only rebuilt when the input or output channel count changes
+	int inChannels[4] = {};
+	int outChannels[4] = {};
+	int copyMode[4] = {};
+	int gather[4][16] = {};
+	
 	Manifold() {
 		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
 
@@ -66,6 +79,23 @@ struct Manifold : Module {
 	void onReset() override {
 	}	
 	
+	// rebuild the routing for the given input/output pair
+	void buildRouting(int x, int inChans, int outChans) {
+		inChannels[x] = inChans;
+		outChannels[x] = outChans;
+		
+		// loop the input channels around so they replicate in order
+		for (int c = 0; c < 16; c++)
+			gather[x][c] = c % inChans;
+		
+		if (inChans % 4 == 0)
+			copyMode[x] = MANIFOLD_BLOCK;
+		else if (4 % inChans == 0)
+			copyMode[x] = MANIFOLD_PATTERN;
+		else
+			copyMode[x] = MANIFOLD_GATHER;
+	}
+	
 	void process(const ProcessArgs &args) override {
 
 		for (int i = 0; i < 2; i++) {
@@ -77,20 +107,38 @@ struct Manifold : Module {
 				
 				if (inputs[SIGNAL_INPUT + x].isConnected()) {
 					int inChans = inputs[SIGNAL_INPUT + x].getChannels();
+					
+					if (inChans != inChannels[x] || outChans != outChannels[x])
+						buildRouting(x, inChans, outChans);
 
 					outputs[SIGNAL_OUTPUT + x].setChannels(outChans);
 					
-					int k = 0; 
-					for (int c = 0; c < outChans; c++) {
-						outputs[SIGNAL_OUTPUT + x].setVoltage(inputs[SIGNAL_INPUT + x].getPolyVoltage(k++), c);
-						
-						// loop the input channels around so they replicate in order
-						if (k >= inChans)
-							k = 0;
+					switch (copyMode[x]) {
+						case MANIFOLD_BLOCK:
+							for (int c = 0; c < outChans; c += 4)
+								outputs[SIGNAL_OUTPUT + x].setVoltageSimd(inputs[SIGNAL_INPUT + x].getVoltageSimd<float_4>(gather[x][c]), c);
+							break;
+						case MANIFOLD_PATTERN:
+							{
+								float_4 v = float_4(inputs[SIGNAL_INPUT + x].getVoltage(gather[x][0]),
+													inputs[SIGNAL_INPUT + x].getVoltage(gather[x][1]),
+													inputs[SIGNAL_INPUT + x].getVoltage(gather[x][2]),
+													inputs[SIGNAL_INPUT + x].getVoltage(gather[x][3]));
+								
+								for (int c = 0; c < outChans; c += 4)
+									outputs[SIGNAL_OUTPUT + x].setVoltageSimd(v, c);
+							}
+							break;
+						default:
+							for (int c = 0; c < outChans; c++)
+								outputs[SIGNAL_OUTPUT + x].setVoltage(inputs[SIGNAL_INPUT + x].getVoltage(gather[x][c]), c);
+							break;
 					}
 				}
-				else
-					outputs[SIGNAL_INPUT + x].channels = 0;
+				else {
+					outputs[SIGNAL_OUTPUT + x].channels = 0;
+					inChannels[x] = 0;
+				}
 			}
 		}
 	}
@@ -10,6 +10,8 @@
 #define THEME_MODULE_NAME MatrixMixer
 #define PANEL_FILE "MatrixMixer.svg"
 
+using simd::float_4;
+
 struct MatrixMixer : Module {
 	enum ParamIds {
 		C1R1_LEVEL_PARAM,
@@ -60,17 +62,15 @@ struct MatrixMixer : Module {
 		NUM_LIGHTS
 	};
 
-	MixerEngine mixers[4];
-
 	int processCount = 8;
 	
-	float mixLevels1[4] = {};
-	float mixLevels2[4] = {};
-	float mixLevels3[4] = {};
-	float mixLevels4[4] = {};
-	float outputLevels[4] = {};
+	// gain matrix stored as one column per input with one lane per mix
+	float_4 mixLevels[4] = {};
+	float_4 outputLevels = {};
 	bool bipolarMode[4] = {};
 	bool prevBipolarMode[4] = {};
+	bool polyphonic = false;
+	int overloads = 0;
 
 	// add the variables we'll use when managing themes
 	#include "../themes/variables.hpp"
@@ -111,6 +111,7 @@ struct MatrixMixer : Module {
 			paramQuantities[C1R4_LEVEL_PARAM + (i * 6)]->minValue = -1.0f;
 		}
 		
+		polyphonic = false;
 		processCount = 8;
 	}
 	
@@ -118,6 +119,7 @@ struct MatrixMixer : Module {
 		json_t *root = json_object();
 
 		json_object_set_new(root, "moduleVersion", json_integer(2));
+		json_object_set_new(root, "polyphonic", json_boolean(polyphonic));
 		
 		// add the theme details
 		#include "../themes/dataToJson.hpp"
@@ -137,6 +139,10 @@ struct MatrixMixer : Module {
 		// grab the theme details
 		#include "../themes/dataFromJson.hpp"
 		
+		json_t *poly = json_object_get(root, "polyphonic");
+		if (poly)
+			polyphonic = json_boolean_value(poly);
+		
 		json_t *modes = json_object_get(root, "modes");
 
 		for (int i = 0; i < 4; i++) {
@@ -165,10 +171,10 @@ struct MatrixMixer : Module {
 				bipolarMode[i] = params[C1_MODE_PARAM + (i * 6)].getValue() > 0.5f;
 
 				// grab the final mix levelsvalues
-				mixLevels1[i] = params[C1R1_LEVEL_PARAM + (i * 6)].getValue();
-				mixLevels2[i] = params[C1R2_LEVEL_PARAM + (i * 6)].getValue();
-				mixLevels3[i] = params[C1R3_LEVEL_PARAM + (i * 6)].getValue();
-				mixLevels4[i] = params[C1R4_LEVEL_PARAM + (i * 6)].getValue();
+				mixLevels[0][i] = params[C1R1_LEVEL_PARAM + (i * 6)].getValue();
+				mixLevels[1][i] = params[C1R2_LEVEL_PARAM + (i * 6)].getValue();
+				mixLevels[2][i] = params[C1R3_LEVEL_PARAM + (i * 6)].getValue();
+				mixLevels[3][i] = params[C1R4_LEVEL_PARAM + (i * 6)].getValue();
 				
 				// now handle change of polarity
 				if (bipolarMode[i] != prevBipolarMode[i]) {
@@ -183,16 +189,16 @@ struct MatrixMixer : Module {
 
 					// on change of mode, adjust the control value so it stays in the same position
 					if (bipolarMode[i]) {
-						params[C1R1_LEVEL_PARAM + (i * 6)].setValue((mixLevels1[i]/1.0f * 2.0f) - 1.0f);
-						params[C1R2_LEVEL_PARAM + (i * 6)].setValue((mixLevels2[i]/1.0f * 2.0f) - 1.0f);
-						params[C1R3_LEVEL_PARAM + (i * 6)].setValue((mixLevels3[i]/1.0f * 2.0f) - 1.0f);
-						params[C1R4_LEVEL_PARAM + (i * 6)].setValue((mixLevels4[i]/1.0f * 2.0f) - 1.0f);
+						params[C1R1_LEVEL_PARAM + (i * 6)].setValue((mixLevels[0][i]/1.0f * 2.0f) - 1.0f);
+						params[C1R2_LEVEL_PARAM + (i * 6)].setValue((mixLevels[1][i]/1.0f * 2.0f) - 1.0f);
+						params[C1R3_LEVEL_PARAM + (i * 6)].setValue((mixLevels[2][i]/1.0f * 2.0f) - 1.0f);
+						params[C1R4_LEVEL_PARAM + (i * 6)].setValue((mixLevels[3][i]/1.0f * 2.0f) - 1.0f);
 					}
 					else {
-						params[C1R1_LEVEL_PARAM + (i * 6)].setValue((mixLevels1[i] + 1.0f) / 2.0f);
-						params[C1R2_LEVEL_PARAM + (i * 6)].setValue((mixLevels2[i] + 1.0f) / 2.0f);
-						params[C1R3_LEVEL_PARAM + (i * 6)].setValue((mixLevels3[i] + 1.0f) / 2.0f);
-						params[C1R4_LEVEL_PARAM + (i * 6)].setValue((mixLevels4[i] + 1.0f) / 2.0f);
+						params[C1R1_LEVEL_PARAM + (i * 6)].setValue((mixLevels[0][i] + 1.0f) / 2.0f);
+						params[C1R2_LEVEL_PARAM + (i * 6)].setValue((mixLevels[1][i] + 1.0f) / 2.0f);
+						params[C1R3_LEVEL_PARAM + (i * 6)].setValue((mixLevels[2][i] + 1.0f) / 2.0f);
+						params[C1R4_LEVEL_PARAM + (i * 6)].setValue((mixLevels[3][i] + 1.0f) / 2.0f);
 					}
 				}
 				
@@ -202,19 +208,58 @@ struct MatrixMixer : Module {
 			}
 		}
 		
-		float st = args.sampleTime * 4.0f;
-		float v1 = inputs[R1_INPUT].getNormalVoltage(10.0f);
-		float v2 = inputs[R2_INPUT].getVoltage();
-		float v3 = inputs[R3_INPUT].getVoltage();
-		float v4 = inputs[R4_INPUT].getVoltage();
-
-		for (int i = 0; i < 4; i++) {
-			outputs[C1_OUTPUT + i].setVoltage(mixers[i].process(v1, v2, v3, v4, 
-				mixLevels1[i], mixLevels2[i], mixLevels3[i], mixLevels4[i], 
-				outputLevels[i], false));
+		if (polyphonic)
+			processPoly();
+		else {
+			// 4x4 matrix-vector product - each input scales its column of mix levels
+			float_4 mix = (mixLevels[0] * inputs[R1_INPUT].getNormalVoltage(10.0f)) +
+							(mixLevels[1] * inputs[R2_INPUT].getVoltage()) +
+							(mixLevels[2] * inputs[R3_INPUT].getVoltage()) +
+							(mixLevels[3] * inputs[R4_INPUT].getVoltage());
+			
+			mix *= outputLevels;
+			
+			overloads = simd::movemask(simd::fabs(mix) > 10.0f);
+			mix = mixerSaturate(mix);
+			
+			for (int i = 0; i < 4; i++) {
+				outputs[C1_OUTPUT + i].setChannels(1);
+				outputs[C1_OUTPUT + i].setVoltage(mix[i]);
+			}
+		}
+		
+		if (processCount == 0) {
+			float st = args.sampleTime * 4.0f;
+			for (int i = 0; i < 4; i++)
+				lights[C1_OVERLOAD_LIGHT  + i].setSmoothBrightness((overloads & (1 << i)) ? 1.0f : 0.0f, st);
+		}
+	}
+	
+	// apply the same matrix to each channel of the polyphonic inputs, 4 channels at a time
+	void processPoly() {
+		int channels = inputs[R1_INPUT].isConnected() ? inputs[R1_INPUT].getChannels() : 1;
+		for (int j = 1; j < 4; j++)
+			channels = std::max(channels, inputs[R1_INPUT + j].getChannels());
+		
+		for (int i = 0; i < 4; i++)
+			outputs[C1_OUTPUT + i].setChannels(channels);
+		
+		overloads = 0;
+		float_4 in[4];
+		for (int c = 0; c < channels; c += 4) {
+			in[0] = inputs[R1_INPUT].getNormalPolyVoltageSimd<float_4>(10.0f, c);
+			for (int j = 1; j < 4; j++)
+				in[j] = inputs[R1_INPUT + j].getNormalPolyVoltageSimd<float_4>(0.0f, c);
 			
-			if (processCount == 0)
-				lights[C1_OVERLOAD_LIGHT  + i].setSmoothBrightness(mixers[i].overloadLevel, st);
+			int laneMask = (1 << std::min(channels - c, 4)) - 1;
+			for (int i = 0; i < 4; i++) {
+				float_4 mix = ((in[0] * mixLevels[0][i]) + (in[1] * mixLevels[1][i]) + (in[2] * mixLevels[2][i]) + (in[3] * mixLevels[3][i])) * outputLevels[i];
+				
+				if (simd::movemask(simd::fabs(mix) > 10.0f) & laneMask)
+					overloads |= (1 << i);
+				
+				outputs[C1_OUTPUT + i].setVoltageSimd(mixerSaturate(mix), c);
+			}
 		}
 	}
 };
@@ -272,6 +317,15 @@ struct MatrixMixerWidget : ModuleWidget {
 	// include the theme menu item struct we'll when we add the theme menu items
 	#include "../themes/ThemeMenuItem.hpp"
 
+	// polyphonic mode menu item
+	struct PolyphonicMenuItem : MenuItem {
+		MatrixMixer *module;
+	
+		void onAction(const event::Action &e) override {
+			module->polyphonic ^= true;
+		}
+	};
+	
 	void appendContextMenu(Menu *menu) override {
 		MatrixMixer *module = dynamic_cast<MatrixMixer*>(this->module);
 		assert(module);
@@ -281,6 +335,14 @@ struct MatrixMixerWidget : ModuleWidget {
 		
 		// add the theme menu items
 		#include "../themes/themeMenus.hpp"
+		
+		menu->addChild(new MenuSeparator());
+		menu->addChild(createMenuLabel("Settings"));
+		
+		// add the polyphonic mode menu item
+		PolyphonicMenuItem *polyMenuItem = createMenuItem<PolyphonicMenuItem>("Polyphonic", CHECKMARK(module->polyphonic));
+		polyMenuItem->module = module;
+		menu->addChild(polyMenuItem);
 	}	
 	
 	void step() override {
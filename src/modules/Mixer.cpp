@@ -10,6 +10,8 @@
 #define THEME_MODULE_NAME Mixer
 #define PANEL_FILE "Mixer.svg"
 
+using simd::float_4;
+
 struct Mixer : Module {
 	enum ParamIds {
 		R1_LEVEL_PARAM,
@@ -37,12 +39,12 @@ struct Mixer : Module {
 		NUM_LIGHTS
 	};
 
-	MixerEngine mixer;
+	MixerEngine<float> mixer;
+	MixerEngine<float_4> polyMixer;
 
 	bool bipolar;
 	bool prevBipolar;
-	float mixLevels[4] = {};
-	float outputLevel = 0.0f;
+	bool polyphonic = false;
 	
 	int processCount = 8;
 	
@@ -75,6 +77,7 @@ struct Mixer : Module {
 	}
 	
 	void onReset() override {
+		polyphonic = false;
 		processCount = 8;
 	}	
 	
@@ -82,6 +85,7 @@ struct Mixer : Module {
 		json_t *root = json_object();
 
 		json_object_set_new(root, "moduleVersion", json_integer(1));
+		json_object_set_new(root, "polyphonic", json_boolean(polyphonic));
 		
 		// add the theme details
 		#include "../themes/dataToJson.hpp"		
@@ -90,6 +94,10 @@ struct Mixer : Module {
 	}
 	
 	void dataFromJson(json_t* root) override {
+		json_t *poly = json_object_get(root, "polyphonic");
+		if (poly)
+			polyphonic = json_boolean_value(poly);
+		
 		// grab the theme details
 		#include "../themes/dataFromJson.hpp"
 	}
@@ -99,24 +107,51 @@ struct Mixer : Module {
 		if (++processCount > 8) {
 			processCount = 0;
 			
-			mixLevels[0] = params[R1_LEVEL_PARAM].getValue();
-			mixLevels[1] = params[R2_LEVEL_PARAM].getValue();
-			mixLevels[2] = params[R3_LEVEL_PARAM].getValue();
-			mixLevels[3] = params[R4_LEVEL_PARAM].getValue();
-			outputLevel = params[LEVEL_PARAM].getValue();
-					
 			bipolar = params[MODE_PARAM].getValue() > 0.5f;
+			
+			// the engines only convert the levels when they actually change
+			mixer.setLevels(params[R1_LEVEL_PARAM].getValue(), params[R2_LEVEL_PARAM].getValue(), params[R3_LEVEL_PARAM].getValue(), params[R4_LEVEL_PARAM].getValue(), 
+				params[LEVEL_PARAM].getValue(), bipolar);
+			polyMixer.setLevels(params[R1_LEVEL_PARAM].getValue(), params[R2_LEVEL_PARAM].getValue(), params[R3_LEVEL_PARAM].getValue(), params[R4_LEVEL_PARAM].getValue(), 
+				params[LEVEL_PARAM].getValue(), bipolar);
 		}
 		
-		float out = mixer.process(inputs[R1_INPUT].getNormalVoltage(10.0f), inputs[R2_INPUT].getVoltage(), inputs[R3_INPUT].getVoltage(), inputs[R4_INPUT].getVoltage(), 
-			mixLevels[0],mixLevels[1], mixLevels[2], mixLevels[3], 
-			outputLevel, bipolar);
+		float overloadLevel = 0.0f;
+		if (polyphonic) {
+			int channels = inputs[R1_INPUT].isConnected() ? inputs[R1_INPUT].getChannels() : 1;
+			for (int i = 1; i < 4; i++)
+				channels = std::max(channels, inputs[R1_INPUT + i].getChannels());
+			
+			outputs[MIX_OUTPUT].setChannels(channels);
+			outputs[XIM_OUTPUT].setChannels(channels);
 			
-		outputs[MIX_OUTPUT].setVoltage(out);
-		outputs[XIM_OUTPUT].setVoltage(-out);
+			for (int c = 0; c < channels; c += 4) {
+				float_4 out = polyMixer.process(inputs[R1_INPUT].getNormalPolyVoltageSimd<float_4>(10.0f, c), 
+												inputs[R2_INPUT].getNormalPolyVoltageSimd<float_4>(0.0f, c), 
+												inputs[R3_INPUT].getNormalPolyVoltageSimd<float_4>(0.0f, c), 
+												inputs[R4_INPUT].getNormalPolyVoltageSimd<float_4>(0.0f, c));
+				
+				outputs[MIX_OUTPUT].setVoltageSimd(out, c);
+				outputs[XIM_OUTPUT].setVoltageSimd(-out, c);
+				
+				// only look at the lanes that are actually in use
+				if (simd::movemask(polyMixer.overloadLevel > 0.0f) & ((1 << std::min(channels - c, 4)) - 1))
+					overloadLevel = 1.0f;
+			}
+		}
+		else {
+			float out = mixer.process(inputs[R1_INPUT].getNormalVoltage(10.0f), inputs[R2_INPUT].getVoltage(), inputs[R3_INPUT].getVoltage(), inputs[R4_INPUT].getVoltage());
+			
+			outputs[MIX_OUTPUT].setChannels(1);
+			outputs[XIM_OUTPUT].setChannels(1);
+			outputs[MIX_OUTPUT].setVoltage(out);
+			outputs[XIM_OUTPUT].setVoltage(-out);
+			
+			overloadLevel = mixer.overloadLevel;
+		}
 		
 		if (processCount == 0)
-			lights[OVERLOAD_LIGHT].setSmoothBrightness(mixer.overloadLevel, args.sampleTime * 4);
+			lights[OVERLOAD_LIGHT].setSmoothBrightness(overloadLevel, args.sampleTime * 4);
 	}
 };
 
@@ -159,6 +194,15 @@ struct MixerWidget : ModuleWidget {
 	// include the theme menu item struct we'll when we add the theme menu items
 	#include "../themes/ThemeMenuItem.hpp"
 
+	// polyphonic mode menu item
+	struct PolyphonicMenuItem : MenuItem {
+		Mixer *module;
+	
+		void onAction(const event::Action &e) override {
+			module->polyphonic ^= true;
+		}
+	};
+	
 	void appendContextMenu(Menu *menu) override {
 		Mixer *module = dynamic_cast<Mixer*>(this->module);
 		assert(module);
@@ -168,6 +212,14 @@ struct MixerWidget : ModuleWidget {
 		
 		// add the theme menu items
 		#include "../themes/themeMenus.hpp"
+		
+		menu->addChild(new MenuSeparator());
+		menu->addChild(createMenuLabel("Settings"));
+		
+		// add the polyphonic mode menu item
+		PolyphonicMenuItem *polyMenuItem = createMenuItem<PolyphonicMenuItem>("Polyphonic", CHECKMARK(module->polyphonic));
+		polyMenuItem->module = module;
+		menu->addChild(polyMenuItem);
 	}	
 	
 	void step() override {
@@ -4,7 +4,7 @@
 //	Copyright (C) 2019  Adam Verspaget
 //----------------------------------------------------------------------------
 #include "../CountModula.hpp"
-#include "../inc/SlewLimiter.hpp"
+#include "../inc/LagProcessorBank.hpp"
 
 // set the module name for the theme selection functions
 #define THEME_MODULE_NAME MuteIple
@@ -30,7 +30,7 @@ struct MuteIple : Module {
 		NUM_LIGHTS
 	};
 
-	LagProcessor slew[8];
+	LagProcessorBank<8> slew;
 	bool softMute[8];
 	int numChannels[8];
 
@@ -58,10 +58,10 @@ struct MuteIple : Module {
 	}
 	
 	void onReset() override {
-		for (int i = 0; i < 8 ; i++) {
-			slew[i].reset();
+		for (int i = 0; i < 8 ; i++)
 			softMute[i] = false;
-		}
+		
+		slew.reset();
 	}
 
 	json_t *dataToJson() override {
@@ -108,30 +108,35 @@ struct MuteIple : Module {
 		numChannels[4] = numChannels[5] = numChannels [6] = numChannels[7] = in2.getChannels();
 
 		
-		// send the inputs to the outputs
-		float mute;
-		for (int i = 0; i < 8; i++) {
-			// grab the mute status for this output
-			mute = (params[MUTE_PARAMS + i].getValue() > 0.5 ? 0.0f : 1.0f);
+		// grab the mute status for each output
+		float mutes[8];
+		for (int i = 0; i < 8; i++)
+			mutes[i] = (params[MUTE_PARAMS + i].getValue() > 0.5 ? 0.0f : 1.0f);
+		
+		// each group of 4 outputs shares the one mute mode so we can slew them 4 at a time
+		for (int g = 0; g < 2; g++) {
+			float_4 mute = float_4::load(&mutes[g * 4]);
 			
 			// apply the soft mode response if we need to
-			if (softMute[i]) {
+			if (softMute[g * 4]) {
 				// soft mode - apply some slew to soften the switch
-				mute = slew[i].process(mute, 1.0f, 0.1f, 0.1f, args.sampleTime);
+				mute = slew.process(g, mute, 1.0f, 0.1f, 0.1f, args.sampleTime);
 			}
 			else {
 				// hard mode - keep slew in sync but don't use it
-				slew[i].process(mute, 1.0f, 0.01f, 0.01f, args.sampleTime);
+				slew.process(g, mute, 1.0f, 0.01f, 0.01f, args.sampleTime);
 			}
 			
-			// determine the number of channels and send the inputs to the outputs
+			mute.store(&mutes[g * 4]);
+		}
+		
+		// determine the number of channels and send the inputs to the outputs
+		for (int i = 0; i < 8; i++) {
+			Input &in = (i < 4 ? in1 : in2);
+			
 			outputs[SIGNAL_OUTPUTS + i].setChannels(numChannels[i]);
-			for (int c = 0; c < numChannels[i]; c++) {
-				if (i < 4)
-					outputs[SIGNAL_OUTPUTS + i].setVoltage(in1.getVoltage(c) * mute, c);
-				else
-					outputs[SIGNAL_OUTPUTS + i].setVoltage(in2.getVoltage(c) * mute, c);
-			}
+			for (int c = 0; c < numChannels[i]; c += 4)
+				outputs[SIGNAL_OUTPUTS + i].setVoltageSimd(in.getVoltageSimd<float_4>(c) * mutes[i], c);
 		}
 	}
 };
@@ -99,8 +99,14 @@ struct NibbleTriggerSequencer : Module {
 	// add the variables we'll use when managing themes
 	#include "../themes/variables.hpp"
 	
+	// cached expander neighbours
+	ExpanderTopology expanders;
+	
 	NibbleTriggerSequencer() {
 		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
+
+		// expander neighbours
+		expanders.config(this, NULL, isOctetTriggerSequencerExpander);
 		
 		configParam(PATTERN_A1_PARAM, 0.0f, 15.0f, 8.0f, "Pattern A1-4 select");
 		configParam(PATTERN_A5_PARAM, 0.0f, 15.0f, 8.0f, "Pattern A5-8 select");
@@ -217,6 +223,10 @@ struct NibbleTriggerSequencer : Module {
 		}
 	}
 	
+	void onExpanderChange(const ExpanderChangeEvent &e) override {
+		expanders.update();
+	}
+	
 	void process(const ProcessArgs &args) override {
 
 		// process reset input
@@ -342,13 +352,11 @@ struct NibbleTriggerSequencer : Module {
 		}
 		
 		// set up details for the expander
-		if (rightExpander.module) {
-			if (isExpanderModule(rightExpander.module)) {
-				OctetTriggerSequencerExpanderMessage *messageToExpander = (OctetTriggerSequencerExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
-				messageToExpander->set(count, clockEdge, actualPatternA, actualPatternB, 1, true, playingChannelB, true, CHAINED_MODE_B_OFF, processCount, gate, false);
-				
-				rightExpander.module->leftExpander.messageFlipRequested = true;
-			}
+		if (expanders.right()) {
+			OctetTriggerSequencerExpanderMessage *messageToExpander = (OctetTriggerSequencerExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
+			messageToExpander->set(count, clockEdge, actualPatternA, actualPatternB, 1, true, playingChannelB, true, CHAINED_MODE_B_OFF, processCount, gate, false);
+			
+			rightExpander.module->leftExpander.messageFlipRequested = true;
 		}
 	}
 };
@@ -106,8 +106,14 @@ struct OctetTriggerSequencer : Module {
 	// add the variables we'll use when managing themes
 	#include "../themes/variables.hpp"
 	
+	// cached expander neighbours
+	ExpanderTopology expanders;
+	
 	OctetTriggerSequencer() {
 		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
+
+		// expander neighbours
+		expanders.config(this, NULL, isOctetTriggerSequencerExpander);
 		
 		configParam(PATTERN_A_CV_PARAM, -1.0f, 1.0f, 0.0f, "Pattern A CV amount", " %", 0.0f, 100.0f, 0.0f);
 		configParam(PATTERN_B_CV_PARAM, -1.0f, 1.0f, 0.0f, "Pattern B CV amount", " %", 0.0f, 100.0f, 0.0f);
@@ -243,6 +249,10 @@ struct OctetTriggerSequencer : Module {
 		}
 	}
 	
+	void onExpanderChange(const ExpanderChangeEvent &e) override {
+		expanders.update();
+	}
+	
 	void process(const ProcessArgs &args) override {
 		
 		// process reset input
@@ -410,13 +420,11 @@ struct OctetTriggerSequencer : Module {
 		}
 		
 		// set up details for the expander
-		if (rightExpander.module) {
-			if (isExpanderModule(rightExpander.module)) {
-				OctetTriggerSequencerExpanderMessage *messageToExpander = (OctetTriggerSequencerExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
-				messageToExpander->set(count, clockEdge, actualPatternA, actualPatternB, 1, true, playingChannelB, chained, chainedPatternMode, processCount, gates[CHANNEL_A], gates[CHANNEL_B]);
-				
-				rightExpander.module->leftExpander.messageFlipRequested = true;
-			}
+		if (expanders.right()) {
+			OctetTriggerSequencerExpanderMessage *messageToExpander = (OctetTriggerSequencerExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
+			messageToExpander->set(count, clockEdge, actualPatternA, actualPatternB, 1, true, playingChannelB, chained, chainedPatternMode, processCount, gates[CHANNEL_A], gates[CHANNEL_B]);
+			
+			rightExpander.module->leftExpander.messageFlipRequested = true;
 		}		
 	}
 };
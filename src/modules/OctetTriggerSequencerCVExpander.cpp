@@ -77,8 +77,14 @@ struct STRUCT_NAME : Module {
 	// count to bit mappping
 	STEP_MAP;
 
+	// cached expander neighbours
+	ExpanderTopology expanders;
+	
 	STRUCT_NAME() {
 		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
+
+		// expander neighbours
+		expanders.config(this, isOctetTriggerSequencerChainModule, isOctetTriggerSequencerExpander);
 		
 		// cv/gate params
 		char stepText[20];
@@ -136,6 +142,10 @@ struct STRUCT_NAME : Module {
 		doRedraw = true;
 	}
 
+	void onExpanderChange(const ExpanderChangeEvent &e) override {
+		expanders.update();
+	}
+	
 	void process(const ProcessArgs &args) override {
 
 		bool clockEdge = false;
@@ -145,29 +155,25 @@ struct STRUCT_NAME : Module {
 		// grab the detail from the left hand module if we have one
 		currentChannel = 0;
 		messagesFromMaster = 0; 
-		if (leftExpander.module) {
-			if (isExpanderModule(leftExpander.module) || isExpandableModule(leftExpander.module)) {
-				messagesFromMaster = (OctetTriggerSequencerExpanderMessage *)(leftExpander.consumerMessage);
-
-				count = messagesFromMaster->counter;
-				clockEdge = messagesFromMaster->clockEdge;
-				selectedPatternA = messagesFromMaster->selectedPatternA;
-				selectedPatternB = messagesFromMaster->selectedPatternB;
-				chained = messagesFromMaster->chained;
-				playingChannelB = messagesFromMaster->playingChannelB;
-				chainedPatternMode = messagesFromMaster->chainedPatternMode;
-				processCount = messagesFromMaster->processCount;
-				gateA = messagesFromMaster ->gateA;
-				gateB = messagesFromMaster ->gateB;
-				
-				if (userChannel == 0)
-					userChannel = messagesFromMaster->channel;
-				
-				if (messagesFromMaster->hasMaster)
-					currentChannel = userChannel;
-			}
-			else if (++processCount > 8)
-				processCount = 0;
+		if (expanders.left()) {
+			messagesFromMaster = (OctetTriggerSequencerExpanderMessage *)(leftExpander.consumerMessage);
+
+			count = messagesFromMaster->counter;
+			clockEdge = messagesFromMaster->clockEdge;
+			selectedPatternA = messagesFromMaster->selectedPatternA;
+			selectedPatternB = messagesFromMaster->selectedPatternB;
+			chained = messagesFromMaster->chained;
+			playingChannelB = messagesFromMaster->playingChannelB;
+			chainedPatternMode = messagesFromMaster->chainedPatternMode;
+			processCount = messagesFromMaster->processCount;
+			gateA = messagesFromMaster ->gateA;
+			gateB = messagesFromMaster ->gateB;
+			
+			if (userChannel == 0)
+				userChannel = messagesFromMaster->channel;
+			
+			if (messagesFromMaster->hasMaster)
+				currentChannel = userChannel;
 		}
 		else if (++processCount > 8)
 			processCount = 0;
@@ -254,28 +260,26 @@ struct STRUCT_NAME : Module {
 		outputs[CVBI_OUTPUT].setVoltage(-cvB * scale);
 
 		// // finally set up the details for any secondary expander
-		if (rightExpander.module) {
-			if (isExpanderModule(rightExpander.module)) {
-				
-				OctetTriggerSequencerExpanderMessage *messageToExpander = (OctetTriggerSequencerExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
-				
-				if (messagesFromMaster) {
-					int ch = 0;
-					if (messagesFromMaster->hasMaster) {
-						ch = messagesFromMaster->channel;
-
-						if (++ch > 7)
-							ch = 1;
-					}
-						
-					messageToExpander->set(count, clockEdge, selectedPatternA, selectedPatternB, ch, messagesFromMaster->hasMaster, playingChannelB, chained, chainedPatternMode, processCount, gateA, gateB);
-				}
-				else {
-					messageToExpander->initialise();
-				}
+		if (expanders.right()) {
+			
+			OctetTriggerSequencerExpanderMessage *messageToExpander = (OctetTriggerSequencerExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
+			
+			if (messagesFromMaster) {
+				int ch = 0;
+				if (messagesFromMaster->hasMaster) {
+					ch = messagesFromMaster->channel;
 
-				rightExpander.module->leftExpander.messageFlipRequested = true;
+					if (++ch > 7)
+						ch = 1;
+				}
+					
+				messageToExpander->set(count, clockEdge, selectedPatternA, selectedPatternB, ch, messagesFromMaster->hasMaster, playingChannelB, chained, chainedPatternMode, processCount, gateA, gateB);
 			}
+			else {
+				messageToExpander->initialise();
+			}
+
+			rightExpander.module->leftExpander.messageFlipRequested = true;
 		}			
 	}
 };
@@ -62,9 +62,15 @@ struct STRUCT_NAME : Module {
 	// count to bit mappping
 	STEP_MAP;
 
+	// cached expander neighbours
+	ExpanderTopology expanders;
+	
 	STRUCT_NAME() {
 		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
 
+		// expander neighbours
+		expanders.config(this, isOctetTriggerSequencerChainModule, isOctetTriggerSequencerExpander);
+
 		for (int i = 0; i < 8; i ++) {
 			configOutput(GATEA_OUTPUTS + i, rack::string::f("Channel A Step %d gate", i + 1));
 			configOutput(GATEB_OUTPUTS + i, rack::string::f("Channel B Step %d gate", i + 1));
@@ -99,28 +105,30 @@ struct STRUCT_NAME : Module {
 		#include "../themes/dataFromJson.hpp"		
 	}
 
+	void onExpanderChange(const ExpanderChangeEvent &e) override {
+		expanders.update();
+	}
+	
 	void process(const ProcessArgs &args) override {
 
 		// grab the detail from the left hand module if we have one
 		clockEdge = chained = playingChannelB = false;
 		count = currentChannel = 0;
 		messagesFromMaster = 0; 
-		if (leftExpander.module) {
-			if (isExpandableModule(leftExpander.module)) {
-				messagesFromMaster = (OctetTriggerSequencerExpanderMessage *)(leftExpander.consumerMessage);
-
-				count = messagesFromMaster->counter;
-				clockEdge = messagesFromMaster->clockEdge;
-				selectedPatternA = messagesFromMaster->selectedPatternA;
-				selectedPatternB = messagesFromMaster->selectedPatternB;
-				chained = messagesFromMaster->chained;
-				playingChannelB = messagesFromMaster->playingChannelB;
-				chainedPatternMode = messagesFromMaster->chainedPatternMode;
-				processCount = messagesFromMaster->processCount;
-				gateA = messagesFromMaster ->gateA;
-				gateB = messagesFromMaster ->gateB;
-				currentChannel = messagesFromMaster->channel;
-			}
+		if (expanders.left()) {
+			messagesFromMaster = (OctetTriggerSequencerExpanderMessage *)(leftExpander.consumerMessage);
+
+			count = messagesFromMaster->counter;
+			clockEdge = messagesFromMaster->clockEdge;
+			selectedPatternA = messagesFromMaster->selectedPatternA;
+			selectedPatternB = messagesFromMaster->selectedPatternB;
+			chained = messagesFromMaster->chained;
+			playingChannelB = messagesFromMaster->playingChannelB;
+			chainedPatternMode = messagesFromMaster->chainedPatternMode;
+			processCount = messagesFromMaster->processCount;
+			gateA = messagesFromMaster ->gateA;
+			gateB = messagesFromMaster ->gateB;
+			currentChannel = messagesFromMaster->channel;
 		}
 		
 		if (clockEdge) {
@@ -171,20 +179,18 @@ struct STRUCT_NAME : Module {
 		}
 		
 		// finally set up the details for any secondary expander
-		if (rightExpander.module) {
-			if (isExpanderModule(rightExpander.module)) {
-				
-				OctetTriggerSequencerExpanderMessage *messageToExpander = (OctetTriggerSequencerExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
-				
-				if (messagesFromMaster) {
-					messageToExpander->set(count, clockEdge, selectedPatternA, selectedPatternB, currentChannel, messagesFromMaster->hasMaster, playingChannelB, chained, chainedPatternMode, processCount, gateA, gateB);
-				}
-				else {
-					messageToExpander->initialise();
-				}
-
-				rightExpander.module->leftExpander.messageFlipRequested = true;
+		if (expanders.right()) {
+			
+			OctetTriggerSequencerExpanderMessage *messageToExpander = (OctetTriggerSequencerExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
+			
+			if (messagesFromMaster) {
+				messageToExpander->set(count, clockEdge, selectedPatternA, selectedPatternB, currentChannel, messagesFromMaster->hasMaster, playingChannelB, chained, chainedPatternMode, processCount, gateA, gateB);
+			}
+			else {
+				messageToExpander->initialise();
 			}
+
+			rightExpander.module->leftExpander.messageFlipRequested = true;
 		}			
 	}
 };
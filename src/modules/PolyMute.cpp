@@ -4,7 +4,7 @@
 //	Copyright (C) 2020  Adam Verspaget
 //----------------------------------------------------------------------------
 #include "../CountModula.hpp"
-#include "../inc/SlewLimiter.hpp"
+#include "../inc/LagProcessorBank.hpp"
 #include "../inc/GateProcessor.hpp"
 
 // set the module name for the theme selection functions
@@ -40,7 +40,7 @@ struct PolyMute : Module {
 	
 	GateProcessor gateMaster;
 	GateProcessor gateMutes[NUM_CHANS];
-	LagProcessor slewMutes[NUM_CHANS];
+	LagProcessorBank<NUM_CHANS> slewMutes;
 	bool softMute;
 	int numChannels;
 
@@ -70,10 +70,10 @@ struct PolyMute : Module {
 	}
 	
 	void onReset() override {
-		for (int i = 0; i < NUM_CHANS ; i++) {
-			slewMutes[i].reset();
+		for (int i = 0; i < NUM_CHANS ; i++)
 			gateMutes[i].reset();
-		}
+		
+		slewMutes.reset();
 		
 		softMute = false;
 	}
@@ -108,26 +108,31 @@ struct PolyMute : Module {
 		
 			outputs[POLY_OUTPUT].setChannels(numChannels);
 
-			// send the inputs to the outputs
-			float mute;
+			// grab the mute status for each output
+			float mutes[NUM_CHANS];
 			for (int i = 0; i < NUM_CHANS; i++) {
 				gateMutes[i].set(inputs[MUTE_INPUT].getNormalPolyVoltage(params[MUTE_PARAMS + i].getValue() * 10.0f, i));
 				params[MUTE_PARAMS + i].setValue(gateMutes[i].high() ? 1.0f : 0.0f);
 				
-				// grab the mute status for this output
-				 mute = (gateMaster.high() || gateMutes[i].high()) ? 0.0f : 1.0f;
+				mutes[i] = (gateMaster.high() || gateMutes[i].high()) ? 0.0f : 1.0f;
+			}
+			
+			// send the inputs to the outputs 4 channels at a time
+			for (int c = 0; c < NUM_CHANS; c += 4) {
+				float_4 mute = float_4::load(&mutes[c]);
 							
 				// apply the soft mode response if we need to
 				if (softMute) {
 					// soft mode - apply some slew to soften the switch
-					mute = slewMutes[i].process(mute, 1.0f, 0.1f, 0.1f, args.sampleTime);
+					mute = slewMutes.process(c / 4, mute, 1.0f, 0.1f, 0.1f, args.sampleTime);
 				}
 				else {
 					// hard mode - keep slew in sync but don't use it
-					slewMutes[i].process(mute, 1.0f, 0.01f, 0.01f, args.sampleTime);
+					slewMutes.process(c / 4, mute, 1.0f, 0.01f, 0.01f, args.sampleTime);
 				}
 				
-				outputs[POLY_OUTPUT].setVoltage(inputs[POLY_INPUT].getVoltage(i) * mute, i);
+				if (c < numChannels)
+					outputs[POLY_OUTPUT].setVoltageSimd(inputs[POLY_INPUT].getVoltageSimd<float_4>(c) * mute, c);
 			}
 		}
 		else {
@@ -30,7 +30,7 @@ struct PolyVCPolarizer : Module {
 		NUM_LIGHTS
 	};
 
-	Polarizer polarizer;
+	PolarizerSimd polarizer[PORT_MAX_CHANNELS / 4];
 	bool isConnected;
 	int count = 0;
 	
@@ -72,7 +72,8 @@ struct PolyVCPolarizer : Module {
 	}
 	
 	void onReset() override {
-		polarizer.reset();
+		for (int g = 0; g < PORT_MAX_CHANNELS / 4; g++)
+			polarizer[g].reset();
 		
 		for (int c = 0; c < 16; c++) {
 			lights[STATUS_LIGHT + (c * 2)].setBrightness(0.0f);
@@ -90,19 +91,27 @@ struct PolyVCPolarizer : Module {
 
 			outputs[SIGNAL_OUTPUT].setChannels(n);
 			
-			for (int c = 0; c < 16; c++) {
-				float cv = inputs[CV_INPUT].getPolyVoltage(c);
-				polarizer.process(inputs[SIGNAL_INPUT].getPolyVoltage(c), manual, cv, cvAmount);
+			// only the connected channels need processing
+			for (int c = 0; c < n; c += 4) {
+				float_4 cv = inputs[CV_INPUT].getPolyVoltageSimd<float_4>(c);
+				outputs[SIGNAL_OUTPUT].setVoltageSimd(polarizer[c / 4].process(inputs[SIGNAL_INPUT].getVoltageSimd<float_4>(c), manual, cv, cvAmount), c);
+			}
 		
-				if (count == 0) {
-					lights[STATUS_LIGHT + (c * 2)].setBrightness(polarizer.negativeLevel);
-					lights[STATUS_LIGHT + (c * 2) + 1].setBrightness(polarizer.positiveLevel);
+			if (count == 0) {
+				for (int c = 0; c < PORT_MAX_CHANNELS; c += 4) {
+					// the lights show the polarity of every channel so bring the ones we didn't process up to date
+					if (c >= n)
+						polarizer[c / 4].polarity(manual, inputs[CV_INPUT].getPolyVoltageSimd<float_4>(c), cvAmount);
+					
+					float_4 negative = polarizer[c / 4].negativeLevel();
+					float_4 positive = polarizer[c / 4].positiveLevel();
+					
+					for (int i = 0; i < 4; i++) {
+						lights[STATUS_LIGHT + ((c + i) * 2)].setBrightness(negative[i]);
+						lights[STATUS_LIGHT + ((c + i) * 2) + 1].setBrightness(positive[i]);
+					}
 				}
-		
-				if (c < n)
-					outputs[SIGNAL_OUTPUT].setVoltage(polarizer.out, c);
 			}
-		
 		}
 		else {
 			outputs[SIGNAL_OUTPUT].channels = 0;
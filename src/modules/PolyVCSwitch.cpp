@@ -4,13 +4,16 @@
 //	Copyright (C) 2020  Adam Verspaget
 //----------------------------------------------------------------------------
 #include "../CountModula.hpp"
-#include "../inc/GateProcessor.hpp"
+#include "../inc/GateProcessorSimd.hpp"
 #include "../inc/Utility.hpp"
 
 // set the module name for the theme selection functions
 #define THEME_MODULE_NAME PolyVCSwitch
 #define PANEL_FILE "PolyVCSwitch.svg"
 
+// crossfade time in seconds when click-free switching is enabled
+#define XFADE_TIME 0.005f
+
 struct PolyVCSwitch : Module {
 	enum ParamIds {
 		MANUAL_PARAM,
@@ -35,12 +38,14 @@ struct PolyVCSwitch : Module {
 		NUM_LIGHTS
 	};
 
-	GateProcessor gateSwitch[16];
+	GateProcessorSimd gateSwitch[4];
+	float_4 xfade[4] = {};
 	
 	bool aConnected = false;
 	bool bConnected = false;
 	bool bUseCV;
-	int nA, nB1, nB2, nB;
+	bool crossfade = false;
+	int nA, nB1, nB2, nB, n;
 	int count = 0;
 	
 	// add the variables we'll use when managing themes
@@ -66,15 +71,19 @@ struct PolyVCSwitch : Module {
 	}
 
 	void onReset() override {
-		for (int i = 0; i < 16; i ++) {
+		for (int i = 0; i < 4; i ++) {
 			gateSwitch[i].reset();
+			xfade[i] = float_4::zero();
 		}
+		
+		crossfade = false;
 	}
 	
 	json_t *dataToJson() override {
 		json_t *root = json_object();
 
 		json_object_set_new(root, "moduleVersion", json_integer(1));
+		json_object_set_new(root, "crossfade", json_boolean(crossfade));
 		
 		// add the theme details
 		#include "../themes/dataToJson.hpp"		
@@ -83,6 +92,10 @@ struct PolyVCSwitch : Module {
 	}
 	
 	void dataFromJson(json_t* root) override {
+		json_t *xf = json_object_get(root, "crossfade");
+		if (xf)
+			crossfade = json_boolean_value(xf);
+		
 		// grab the theme details
 		#include "../themes/dataFromJson.hpp"
 	}
@@ -117,38 +130,59 @@ struct PolyVCSwitch : Module {
 			outputs[B_OUTPUT].channels = 0;
 		}
 		
-		for (int c = 0; c < 16; c++) {
-			if (bUseCV)
-				gateSwitch[c].set(inputs[CV_INPUT].getPolyVoltage(c));
-			else
-				gateSwitch[c].set(manual);
+		// only process as many channels as we actually need, the remaining select lights are updated at UI rate
+		n = std::max(aConnected ? nA : 0, bConnected ? nB : 0);
+		
+		float_4 xfStep = args.sampleTime / XFADE_TIME;
+		for (int c = 0; c < n; c += 4) {
+			int g = c >> 2;
+			
+			float_4 select = gateSwitch[g].set(bUseCV ? inputs[CV_INPUT].getPolyVoltageSimd<float_4>(c) : float_4(manual));
 			
-			if (gateSwitch[c].high()) {
-				// IN A -> OUT A2
-				if (aConnected && c < nA) {
-					outputs[A1_OUTPUT].setVoltage(0.0f, c);
-					outputs[A2_OUTPUT].setVoltage(inputs[A_INPUT].getVoltage(c), c);
+			if (crossfade) {
+				// ramp each channel towards its selected position
+				xfade[g] += simd::clamp((select & 1.0f) - xfade[g], -xfStep, xfStep);
+				
+				// IN A -> OUT A1/A2
+				if (aConnected) {
+					float_4 a = inputs[A_INPUT].getVoltageSimd<float_4>(c);
+					outputs[A1_OUTPUT].setVoltageSimd(a - (a * xfade[g]), c);
+					outputs[A2_OUTPUT].setVoltageSimd(a * xfade[g], c);
 				}
 				
-				// IN B2 -> OUT B
-				if (bConnected)
-					outputs[B_OUTPUT].setVoltage(inputs[B2_INPUT].getPolyVoltage(c), c);
+				// IN B1/B2 -> OUT B
+				if (bConnected) {
+					float_4 b1 = inputs[B1_INPUT].getPolyVoltageSimd<float_4>(c);
+					float_4 b2 = inputs[B2_INPUT].getPolyVoltageSimd<float_4>(c);
+					outputs[B_OUTPUT].setVoltageSimd(b1 + ((b2 - b1) * xfade[g]), c);
+				}
 			}
 			else {
-				// IN A -> OUT A1
-				if (aConnected && c < nA) {
-					outputs[A1_OUTPUT].setVoltage(inputs[A_INPUT].getVoltage(c), c);
-					outputs[A2_OUTPUT].setVoltage(0.0f, c);
+				// keep the crossfade position in step so enabling it does not cause a jump
+				xfade[g] = select & 1.0f;
+				
+				// IN A -> OUT A1/A2
+				if (aConnected) {
+					float_4 a = inputs[A_INPUT].getVoltageSimd<float_4>(c);
+					outputs[A1_OUTPUT].setVoltageSimd(simd::ifelse(select, 0.0f, a), c);
+					outputs[A2_OUTPUT].setVoltageSimd(simd::ifelse(select, a, 0.0f), c);
 				}
 				
-				// IN B1 -> OUT B
+				// IN B1/B2 -> OUT B
 				if (bConnected)
-					outputs[B_OUTPUT].setVoltage(inputs[B1_INPUT].getPolyVoltage(c), c);
+					outputs[B_OUTPUT].setVoltageSimd(simd::ifelse(select, inputs[B2_INPUT].getPolyVoltageSimd<float_4>(c), inputs[B1_INPUT].getPolyVoltageSimd<float_4>(c)), c);
 			}
-			
-			if (count == 0) {
-				lights[SELECT_LIGHT + (c * 2)].setBrightness(boolToLight(gateSwitch[c].low()));
-				lights[SELECT_LIGHT + (c * 2) + 1].setBrightness(boolToLight(gateSwitch[c].high()));
+		}
+		
+		if (count == 0) {
+			// keep the select state of the channels we didn't process up to date for the lights
+			for (int c = (n + 3) & ~3; c < 16; c += 4)
+				gateSwitch[c >> 2].set(bUseCV ? inputs[CV_INPUT].getPolyVoltageSimd<float_4>(c) : float_4(manual));
+
+			for (int c = 0; c < 16; c++) {
+				bool high = gateSwitch[c >> 2].high(c & 3);
+				lights[SELECT_LIGHT + (c * 2)].setBrightness(boolToLight(!high));
+				lights[SELECT_LIGHT + (c * 2) + 1].setBrightness(boolToLight(high));
 			}
 		}
 		
@@ -204,6 +238,15 @@ struct PolyVCSwitchWidget : ModuleWidget {
 	// include the theme menu item struct we'll when we add the theme menu items
 	#include "../themes/ThemeMenuItem.hpp"
 
+	// crossfade menu item
+	struct CrossfadeMenuItem : MenuItem {
+		PolyVCSwitch *module;
+	
+		void onAction(const event::Action &e) override {
+			module->crossfade ^= true;
+		}
+	};
+	
 	void appendContextMenu(Menu *menu) override {
 		PolyVCSwitch *module = dynamic_cast<PolyVCSwitch*>(this->module);
 		assert(module);
@@ -213,6 +256,14 @@ struct PolyVCSwitchWidget : ModuleWidget {
 		
 		// add the theme menu items
 		#include "../themes/themeMenus.hpp"
+		
+		menu->addChild(new MenuSeparator());
+		menu->addChild(createMenuLabel("Settings"));
+		
+		// add the crossfade menu item
+		CrossfadeMenuItem *xfadeMenuItem = createMenuItem<CrossfadeMenuItem>("Click-free switching", CHECKMARK(module->crossfade));
+		xfadeMenuItem->module = module;
+		menu->addChild(xfadeMenuItem);
 	}	
 	
 	void step() override {
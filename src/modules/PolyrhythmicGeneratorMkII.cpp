@@ -6,6 +6,7 @@
 #include "../CountModula.hpp"
 #include "../inc/Utility.hpp"
 #include "../inc/FrequencyDivider.hpp"
+#include "../inc/FrequencyDividerBank.hpp"
 
 // set the module name for the theme selection functions
 #define THEME_MODULE_NAME PolyrhythmicGeneratorMkII
@@ -42,7 +43,7 @@ struct PolyrhythmicGeneratorMkII : Module {
 		NUM_LIGHTS
 	};
 
-	FrequencyDivider dividers[8];
+	FrequencyDividerBank<8> dividers;
 	FrequencyDividerOld legacyDividers[8];
 	
 	float legacyCVMap[16] = {	0.333f,
@@ -133,8 +134,8 @@ struct PolyrhythmicGeneratorMkII : Module {
 		json_t *n = json_array();
 		
 		for (int i = 0; i < 8; i++) {
-			json_array_insert_new(countMode, i, json_integer(dividers[i].countMode));
-			json_array_insert_new(n, i, json_integer(dividers[i].N));
+			json_array_insert_new(countMode, i, json_integer(dividers.getCountMode(i)));
+			json_array_insert_new(n, i, json_integer(dividers.getN(i)));
 		}
 		
 		json_object_set_new(root, "divCountMode", countMode);
@@ -157,19 +158,18 @@ struct PolyrhythmicGeneratorMkII : Module {
 		
 		for (int i = 0; i < 8; i++) {
 			// need to start from the beginning as the positioning of the clock edges cannot be guaranteed so the results can be a little random
-			dividers[i].count = -1;
-			dividers[i].phase = false;
+			dividers.reset(i);
 	
 			if (countMode) {
 				json_t *v = json_array_get(countMode, i);
 				if (v)
-					dividers[i].countMode = json_integer_value(v);
+					dividers.setCountMode(i, json_integer_value(v));
 			}
 	
 			if (n) {
 				json_t *v = json_array_get(n, i);
 				if (v)
-					dividers[i].N = json_integer_value(v);
+					dividers.setN(i, json_integer_value(v));
 			}
 		}
 		
@@ -178,8 +178,9 @@ struct PolyrhythmicGeneratorMkII : Module {
 	}
 	
 	void onReset() override {
+		dividers.reset();
+		
 		for (int i = 0; i < 8; i++) {
-			dividers[i].reset();
 			legacyDividers[i].reset();
 			pgTriggers[i].reset();
 			gpResets[i].reset();
@@ -204,42 +205,57 @@ struct PolyrhythmicGeneratorMkII : Module {
 		bool muteAll = gpMuteAll.high() || params[MUTEALL_PARAM].getValue() > 0.5f;
 		
 		float prevClock = 0.0f;
-		bool prevPhase;
 		float prevReset = 0.0f;
 		float prevCV = 0.0f;
 		
+		float clocks[8];
+		bool prevPhase[8];
+		
 		outputs[POLY_OUTPUT].setChannels(8);
 		
+		// set up the dividers
 		for (int i = 0; i < 8; i++) {
 			// handle the reset input - also reset on change of beat mode
 			float res = inputs[RESET_INPUT + i].getNormalVoltage(prevReset);
 			gpResets[i].set(res);
 			if(gpResets[i].leadingEdge() || prevCountMode != countMode || isStarting) {
-				dividers[i].reset();
+				dividers.reset(i);
 				pgTriggers[i].reset();
 				isStarting = false;
 			}
 
 			// counter mode - always down for legacy mode as it made no real difference
-			dividers[i].setCountMode(countMode);
+			dividers.setCountMode(i, countMode);
 			
 			// save for rising edge determination
-			prevPhase = dividers[i].phase;
+			prevPhase[i] = dividers.state(i);
 			
 			// calculate the current division value and set the division number
 			float divCV = inputs[CV_INPUT + i].getNormalVoltage(prevCV);
 			int div = (int)(params[DIV_PARAM + i].getValue() + (divCV * params[CV_PARAM + i].getValue() * 1.6)); // scale 10V CV up to 16
 			
 			// set the division amount - take into account the legacy mode (the old version was halving the clock so would only div by 2/4/6/8/10 etc)
-			dividers[i].setN(div);
+			dividers.setN(i, div);
 			
-			// clock the divider 
-			float clock = inputs[CLOCK_INPUT + i].getNormalVoltage(prevClock);
-			dividers[i].process(clock);
-			gpClocks[i].set(clock);
+			// grab the clock
+			clocks[i] = inputs[CLOCK_INPUT + i].getNormalVoltage(prevClock);
+			gpClocks[i].set(clocks[i]);
+			
+			// save these values for normalling in the next iteration 
+			prevClock = clocks[i];
+			prevReset = res;
+			prevCV = divCV;
+		}
+		
+		// clock the dividers 4 at a time
+		for (int g = 0; g < 2; g++)
+			dividers.process(g, float_4::load(&clocks[g * 4]));
+		
+		for (int i = 0; i < 8; i++) {
+			bool phase = dividers.state(i);
 			
 			// fire off the trigger on a 0 to 1 rising edge
-			if (!prevPhase &&  dividers[i].phase) {
+			if (!prevPhase[i] && phase) {
 				clockOut[i] = true;
 				pgTriggers[i].trigger(1e-3f);
 			}
@@ -253,17 +269,17 @@ struct PolyrhythmicGeneratorMkII : Module {
 						pgTriggers[i].process(args.sampleTime);
 						break;
 					case 1: // gate
-						trigOut = dividers[i].phase;
+						trigOut = phase;
 						break;
 					case 2: // gated clock
-						trigOut = gpClocks[i].high() &&  dividers[i].phase;
+						trigOut = gpClocks[i].high() && phase;
 						break;
 					case 3:	// clock
-						if (dividers[i].N == 1)
-							trigOut = dividers[i].phase;
+						if (dividers.getN(i) == 1)
+							trigOut = phase;
 						else {
 							trigOut = clockOut[i];
-							if (trigOut && prevPhase &&  dividers[i].phase && gpClocks[i].anyEdge())
+							if (trigOut && prevPhase[i] && phase && gpClocks[i].anyEdge())
 								clockOut[i] = trigOut = false;
 						}
 						break;
@@ -274,11 +290,6 @@ struct PolyrhythmicGeneratorMkII : Module {
 			outputs[POLY_OUTPUT].setVoltage(boolToGate(trigOut), i);
 			outputs[TRIG_OUTPUT + i].setVoltage(boolToGate(trigOut));
 			lights[TRIG_LIGHT + i].setSmoothBrightness(boolToLight(trigOut), args.sampleTime);
-		
-			// save these values for normalling in the next iteration 
-			prevClock = clock;
-			prevReset = res;
-			prevCV = divCV;
 		}
 		
 		prevCountMode = countMode;
@@ -4,7 +4,7 @@
 //----------------------------------------------------------------------------
 #include "../CountModula.hpp"
 #include "../inc/Utility.hpp"
-#include "../inc/GateProcessor.hpp"
+#include "../inc/RandomAccessSelector.hpp"
 
 // set the module name for the theme selection functions
 #define THEME_MODULE_NAME RandomAccessSwitch18
@@ -38,13 +38,15 @@ struct RandomAccessSwitch18 : Module {
 		MODE_SAMPLE_AND_HOLD
 	};
 	
-	GateProcessor gpSelect[8];
+	RandomAccessSelector selector;
 	dsp::PulseGenerator pgChange;
-	int selection = 0, prevSelection = 0;
 	int processCount = 0;
 	int mode = 1;
-	float presetVoltages[8] = {};
-	bool preset = false;
+	
+	// polyphonic mode - each channel selects its own destination
+	bool polyphonic = false;
+	int channels = 1;
+	
 	// add the variables we'll use when managing themes
 	#include "../themes/variables.hpp"	
 	
@@ -60,7 +62,6 @@ struct RandomAccessSwitch18 : Module {
 			configButton(SELECT_PARAM + i, rack::string::f("Select %d", c));
 			configInput(SELECT_INPUT + i, rack::string::f("Select %d", c));
 			configOutput(CV_OUTPUT + i, rack::string::f("Destination %d", c));
-			presetVoltages[i] = 0.0f;
 		}
 		
 		// set the theme from the current default value
@@ -71,8 +72,16 @@ struct RandomAccessSwitch18 : Module {
 		json_t *root = json_object();
 
 		json_object_set_new(root, "moduleVersion", json_integer(1));
-		json_object_set_new(root, "selection", json_integer(selection));
+		json_object_set_new(root, "selection", json_integer(selector.get(0)));
 		json_object_set_new(root, "mode", json_integer(mode));
+		json_object_set_new(root, "polyphonic", json_boolean(polyphonic));
+		
+		// save the individual channel selections
+		json_t *s = json_array();
+		for (int c = 0; c < PORT_MAX_CHANNELS; c++) {
+			json_array_insert_new(s, c, json_integer(selector.get(c)));
+		}
+		json_object_set_new(root, "selections", s);
 		
 		// save the current output voltages
 		json_t *v = json_array();
@@ -92,20 +101,32 @@ struct RandomAccessSwitch18 : Module {
 		json_t *sel = json_object_get(root, "selection");
 		json_t *mod = json_object_get(root, "mode");
 		json_t *vl = json_object_get(root, "outputVoltages");
+		json_t *poly = json_object_get(root, "polyphonic");
+		json_t *sl = json_object_get(root, "selections");
 
 		if (sel)
-			selection = json_integer_value(sel);	
+			selector.set(json_integer_value(sel));	
 
 		if (mod)
 			mode = json_integer_value(mod);	
+		
+		if (poly)
+			polyphonic = json_boolean_value(poly);
+		
+		if (sl) {
+			for (int c = 0; c < PORT_MAX_CHANNELS; c++) {
+				json_t *v = json_array_get(sl, c);
+				if (v)
+					selector.set(c, json_integer_value(v));
+			}
+		}
 			
-		// read the saved output voltages
+		// set the output voltages to what they were when the patch was saved
 		if (vl) {
-			preset = true;
 			for (int i = 0; i < 8 ; i++) {
 				json_t *v = json_array_get(vl, i);
 				if (v) {
-					presetVoltages[i] = json_real_value(v);
+					outputs[CV_OUTPUT + i].setVoltage(json_real_value(v));
 				}
 			}
 		}
@@ -115,56 +136,52 @@ struct RandomAccessSwitch18 : Module {
 	}
 
 	void onReset() override {
-		prevSelection = selection;
-		selection = 0;
+		selector.set(0);
 		pgChange.reset();
+		polyphonic = false;
 	}
 	
 	void process(const ProcessArgs &args) override {
-	
-		// set the output voltages to what they when the patch was saved.
-		if (preset) {
-			DEBUG("Setting preset voltages");
-			for (int i = 0; i < 8 ; i++) {
-				outputs[CV_OUTPUT + i].setVoltage(presetVoltages[i]);
-			}
-			preset = false;
-		}
 
-		bool sample = false;
 		if (++ processCount > 8) {
 			
 			mode = (int)(params[MODE_PARAM].getValue());
 			
-			for (int i = 0; i < 8; i++) {
-				gpSelect[i].set(params[SELECT_PARAM + i].getValue() > 0.5f ? 10.0f : inputs[SELECT_INPUT + i].getVoltage());
-				if (gpSelect[i].leadingEdge()) {
-					selection = i;
-					sample = true;
-				}
+			// in polyphonic mode we use as many channels as there are on the inputs
+			channels = 1;
+			if (polyphonic) {
+				channels = inputs[CV_INPUT].getChannels();
+				for (int i = 0; i < 8; i++)
+					channels = std::max(channels, inputs[SELECT_INPUT + i].getChannels());
+					
+				channels = std::max(channels, 1);
 			}
 			
 			processCount = 0;
 		}
 		
+		// the select gates are checked every sample so we don't miss any fast changes
+		selector.process(&params[SELECT_PARAM], &inputs[SELECT_INPUT], channels);
+		bool sample = (mode == MODE_SAMPLE_AND_HOLD && selector.edges);
+		
 		for (int i = 0; i < 8; i++) {
-			if (i == selection) {
-				lights[SELECT_LIGHT + i].setBrightness(1.0f);
-				if (mode != MODE_SAMPLE_AND_HOLD || (mode == MODE_SAMPLE_AND_HOLD && sample))
-					outputs[CV_OUTPUT + i].setVoltage(inputs[CV_INPUT].getVoltage());
-			}
-			else
-			{
-				lights[SELECT_LIGHT + i].setBrightness(0.0f);
-				if (mode == MODE_PASS_THROUGH)
-					outputs[CV_OUTPUT + i].setVoltage(0.0);
+			outputs[CV_OUTPUT + i].setChannels(channels);
+			
+			for (int c = 0; c < channels; c += 4) {
+				// only the channels that have selected this output take the input, the rest hold or go to 0 in pass through mode
+				float_4 selected = selector.selected(c, i);
+				if (mode == MODE_SAMPLE_AND_HOLD)
+					selected &= selector.sampled(c);
+					
+				float_4 out = (mode == MODE_PASS_THROUGH ? float_4::zero() : outputs[CV_OUTPUT + i].getVoltageSimd<float_4>(c));
+				outputs[CV_OUTPUT + i].setVoltageSimd(simd::ifelse(selected, inputs[CV_INPUT].getPolyVoltageSimd<float_4>(c), out), c);
 			}
+			
+			lights[SELECT_LIGHT + i].setBrightness(boolToLight(selector.selectedBits(i, channels)));
 		}
 		
-		if (prevSelection != selection || (mode == MODE_SAMPLE_AND_HOLD && sample)) {
+		if (selector.changes || sample)
 			pgChange.trigger(1e-3f);
-			prevSelection = selection;
-		}
 		
 		if (pgChange.remaining > 0.0f) {
 			outputs[TRIG_OUTPUT].setVoltage(10.0f);
@@ -223,6 +240,15 @@ struct RandomAccessSwitch18Widget : ModuleWidget {
 	// include the theme menu item struct we'll when we add the theme menu items
 	#include "../themes/ThemeMenuItem.hpp"
 
+	// polyphonic mode menu item
+	struct PolyphonicMenuItem : MenuItem {
+		RandomAccessSwitch18 *module;
+		
+		void onAction(const event::Action &e) override {
+			module->polyphonic ^= true;
+		}
+	};
+
 	void appendContextMenu(Menu *menu) override {
 		RandomAccessSwitch18 *module = dynamic_cast<RandomAccessSwitch18*>(this->module);
 		assert(module);
@@ -232,6 +258,14 @@ struct RandomAccessSwitch18Widget : ModuleWidget {
 		
 		// add the theme menu items
 		#include "../themes/themeMenus.hpp"
+		
+		menu->addChild(new MenuSeparator());
+		menu->addChild(createMenuLabel("Settings"));
+		
+		// add the polyphonic mode menu item
+		PolyphonicMenuItem *polyMenuItem = createMenuItem<PolyphonicMenuItem>("Polyphonic", CHECKMARK(module->polyphonic));
+		polyMenuItem->module = module;
+		menu->addChild(polyMenuItem);
 	}	
 	
 	void step() override {
@@ -4,7 +4,7 @@
 //----------------------------------------------------------------------------
 #include "../CountModula.hpp"
 #include "../inc/Utility.hpp"
-#include "../inc/GateProcessor.hpp"
+#include "../inc/RandomAccessSelector.hpp"
 
 // set the module name for the theme selection functions
 #define THEME_MODULE_NAME RandomAccessSwitch81
@@ -31,11 +31,14 @@ struct RandomAccessSwitch81 : Module {
 		NUM_LIGHTS
 	};
 
-	GateProcessor gpSelect[8];
+	RandomAccessSelector selector;
 	dsp::PulseGenerator pgChange;
-	int selection = 0, prevSelection = 0;
 	int processCount = 0;
 	
+	// polyphonic mode - each channel selects its own source
+	bool polyphonic = false;
+	int channels = 1;
+	
 	// add the variables we'll use when managing themes
 	#include "../themes/variables.hpp"	
 	
@@ -59,7 +62,15 @@ struct RandomAccessSwitch81 : Module {
 		json_t *root = json_object();
 
 		json_object_set_new(root, "moduleVersion", json_integer(1));
-		json_object_set_new(root, "selection", json_integer(selection));
+		json_object_set_new(root, "selection", json_integer(selector.get(0)));
+		json_object_set_new(root, "polyphonic", json_boolean(polyphonic));
+		
+		// save the individual channel selections
+		json_t *s = json_array();
+		for (int c = 0; c < PORT_MAX_CHANNELS; c++) {
+			json_array_insert_new(s, c, json_integer(selector.get(c)));
+		}
+		json_object_set_new(root, "selections", s);
 		
 		// add the theme details
 		#include "../themes/dataToJson.hpp"
@@ -70,10 +81,22 @@ struct RandomAccessSwitch81 : Module {
 	void dataFromJson(json_t* root) override {
 		
 		json_t *sel = json_object_get(root, "selection");
+		json_t *poly = json_object_get(root, "polyphonic");
+		json_t *sl = json_object_get(root, "selections");
 
 		if (sel)
-			selection = json_integer_value(sel);	
+			selector.set(json_integer_value(sel));	
 		
+		if (poly)
+			polyphonic = json_boolean_value(poly);
+		
+		if (sl) {
+			for (int c = 0; c < PORT_MAX_CHANNELS; c++) {
+				json_t *v = json_array_get(sl, c);
+				if (v)
+					selector.set(c, json_integer_value(v));
+			}
+		}
 	
 		// grab the theme details
 		#include "../themes/dataFromJson.hpp"
@@ -81,31 +104,41 @@ struct RandomAccessSwitch81 : Module {
 	
 	void onReset() override {
 		pgChange.reset();
-		prevSelection = selection;
-		selection = 0;
+		selector.set(0);
+		polyphonic = false;
 	}	
 
 	void process(const ProcessArgs &args) override {
 	
 		if (++ processCount > 8) {
-			for (int i = 0; i < 8; i++) {
-				gpSelect[i].set(params[SELECT_PARAM + i].getValue() > 0.5f ? 10.0f : inputs[SELECT_INPUT + i].getVoltage());
-				if (gpSelect[i].leadingEdge()) {
-					selection = i;
-				}
+			// in polyphonic mode we use as many channels as there are on the inputs
+			channels = 1;
+			if (polyphonic) {
+				for (int i = 0; i < 8; i++)
+					channels = std::max(channels, std::max(inputs[CV_INPUT + i].getChannels(), inputs[SELECT_INPUT + i].getChannels()));
 			}
 
 			processCount = 0;
 		}
+		
+		// the select gates are checked every sample so we don't miss any fast changes
+		selector.process(&params[SELECT_PARAM], &inputs[SELECT_INPUT], channels);
 
-		outputs[CV_OUTPUT].setVoltage(inputs[CV_INPUT + selection].getVoltage());
-		lights[SELECT_LIGHT + selection].setBrightness(1.0f);
+		outputs[CV_OUTPUT].setChannels(channels);
+		if (channels == 1)
+			outputs[CV_OUTPUT].setVoltage(inputs[CV_INPUT + selector.get(0)].getVoltage());
+		else {
+			for (int c = 0; c < channels; c++)
+				outputs[CV_OUTPUT].setVoltage(inputs[CV_INPUT + selector.get(c)].getPolyVoltage(c), c);
+		}
 
-		if (prevSelection != selection) {
+		if (selector.changes)
 			pgChange.trigger(1e-3f);
-			lights[SELECT_LIGHT + prevSelection].setBrightness(0.0f);
-			
-			prevSelection = selection;
+		
+		// the channel count can change too so keep the lights up to date at the slower rate as well
+		if (selector.changes || processCount == 0) {
+			for (int i = 0; i < 8; i++)
+				lights[SELECT_LIGHT + i].setBrightness(boolToLight(selector.selectedBits(i, channels)));
 		}
 	
 		if (pgChange.remaining > 0.0f) {
@@ -162,6 +195,15 @@ struct RandomAccessSwitch81Widget : ModuleWidget {
 	// include the theme menu item struct we'll when we add the theme menu items
 	#include "../themes/ThemeMenuItem.hpp"
 
+	// polyphonic mode menu item
+	struct PolyphonicMenuItem : MenuItem {
+		RandomAccessSwitch81 *module;
+		
+		void onAction(const event::Action &e) override {
+			module->polyphonic ^= true;
+		}
+	};
+
 	void appendContextMenu(Menu *menu) override {
 		RandomAccessSwitch81 *module = dynamic_cast<RandomAccessSwitch81*>(this->module);
 		assert(module);
@@ -171,6 +213,14 @@ struct RandomAccessSwitch81Widget : ModuleWidget {
 		
 		// add the theme menu items
 		#include "../themes/themeMenus.hpp"
+		
+		menu->addChild(new MenuSeparator());
+		menu->addChild(createMenuLabel("Settings"));
+		
+		// add the polyphonic mode menu item
+		PolyphonicMenuItem *polyMenuItem = createMenuItem<PolyphonicMenuItem>("Polyphonic", CHECKMARK(module->polyphonic));
+		polyMenuItem->module = module;
+		menu->addChild(polyMenuItem);
 	}	
 	
 	void step() override {
@@ -12,6 +12,8 @@
 #define THEME_MODULE_NAME Rectifier
 #define PANEL_FILE "Rectifier.svg"
 
+using simd::float_4;
+
 struct Rectifier : Module {
 	enum ParamIds {
 		CV_PARAM,
@@ -92,20 +94,33 @@ struct Rectifier : Module {
 		outputs[PHRI_OUTPUT].setChannels(n);
 		outputs[NHRI_OUTPUT].setChannels(n);
 		
-		// now process each channel
-		float v, posHalf, negHalf;
-		for (int c = 0; c < n; c++) {
-			v = inputs[SIGNAL_INPUT].getVoltage(c);
-			posHalf = clamp(fmaxf(v, axis), -12.0f, 12.0f);
-			negHalf = clamp(fminf(v, axis), -12.0f, 12.0f);
+		// which outputs do we need to bother with
+		bool phr = outputs[PHR_OUTPUT].isConnected();
+		bool nhr = outputs[NHR_OUTPUT].isConnected();
+		bool fwr = outputs[FWR_OUTPUT].isConnected();
+		bool phri = outputs[PHRI_OUTPUT].isConnected();
+		bool nhri = outputs[NHRI_OUTPUT].isConnected();
+		bool fwri = outputs[FWRI_OUTPUT].isConnected();
+		
+		// now process the channels 4 at a time
+		for (int c = 0; c < n; c += 4) {
+			float_4 v = inputs[SIGNAL_INPUT].getVoltageSimd<float_4>(c);
+			float_4 posHalf = simd::clamp(simd::fmax(v, axis), -12.0f, 12.0f);
+			float_4 negHalf = simd::clamp(simd::fmin(v, axis), -12.0f, 12.0f);
 		
-			outputs[PHR_OUTPUT].setVoltage(posHalf, c);
-			outputs[NHR_OUTPUT].setVoltage(negHalf, c);
-			outputs[FWR_OUTPUT].setVoltage(posHalf - negHalf, c);
+			if (phr)
+				outputs[PHR_OUTPUT].setVoltageSimd(posHalf, c);
+			if (nhr)
+				outputs[NHR_OUTPUT].setVoltageSimd(negHalf, c);
+			if (fwr)
+				outputs[FWR_OUTPUT].setVoltageSimd(posHalf - negHalf, c);
 			
-			outputs[PHRI_OUTPUT].setVoltage(-posHalf, c);
-			outputs[NHRI_OUTPUT].setVoltage(-negHalf, c);
-			outputs[FWRI_OUTPUT].setVoltage(-(posHalf - negHalf), c);
+			if (phri)
+				outputs[PHRI_OUTPUT].setVoltageSimd(-posHalf, c);
+			if (nhri)
+				outputs[NHRI_OUTPUT].setVoltageSimd(-negHalf, c);
+			if (fwri)
+				outputs[FWRI_OUTPUT].setVoltageSimd(-(posHalf - negHalf), c);
 		}
 	}	
 };
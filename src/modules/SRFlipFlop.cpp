@@ -5,71 +5,49 @@
 //----------------------------------------------------------------------------
 #include "../CountModula.hpp"
 #include "../inc/Utility.hpp"
-#include "../inc/GateProcessor.hpp"
+#include "../inc/LatchBank.hpp"
 
 // set the module name for the theme selection functions
 #define THEME_MODULE_NAME SRFlipFlop
 #define PANEL_FILE "SRFlipFlop.svg"
 
-// implements a basic SR flip flop
-struct SRLatch {
-	GateProcessor S;
-	GateProcessor R;
-	GateProcessor E;
-
-	bool stateQ = false; 
-	bool stateNQ = true;
+// implements a basic SR flip flop for up to 16 channels
+struct SRLatch : LatchBank {
+	GateProcessorSimd S[PORT_MAX_CHANNELS / 4];
+	GateProcessorSimd R[PORT_MAX_CHANNELS / 4];
+	GateProcessorSimd E[PORT_MAX_CHANNELS / 4];
 	
-	float process (float sIn, float rIn, float enIn) {
-		S.set(sIn);
-		R.set(rIn);
-		E.set(enIn);
-
-		if (E.high()) {
-			if(R.high() && S.high()) {
-				// invalid state
-				stateQ = stateNQ = true;
-			}
-			else if (R.high() && S.low()) {
-				stateQ = false;
-				stateNQ = true;
-			}
-			else if (R.low() && S.high()) {
-				stateQ = true;
-				stateNQ = false;
-			}
+	void process (Input &sIn, Input &rIn, Input &enIn, int channels) {
+		uint16_t s = 0, r = 0, e = 0;
+		
+		for (int c = 0; c < channels; c += 4) {
+			S[c / 4].set(sIn.getPolyVoltageSimd<float_4>(c));
+			R[c / 4].set(rIn.getPolyVoltageSimd<float_4>(c));
+			E[c / 4].set(enIn.getNormalPolyVoltageSimd<float_4>(10.0f, c));
+			
+			s |= bits(S[c / 4].high(), c);
+			r |= bits(R[c / 4].high(), c);
+			e |= bits(E[c / 4].high(), c);
 		}
+
+		e &= channelBits(channels);
+		s &= e;
+		r &= e;
 		
-		return boolToGate(stateQ);
+		// set and reset together is the invalid state where both outputs go high
+		stateQ = (stateQ & ~(r & ~s)) | s;
+		stateNQ = (stateNQ & ~(s & ~r)) | r;
 	}
 	
 	void reset () {
-		S.reset();
-		R.reset();
-		E.reset();
-		stateQ = false; 
-		stateNQ = true;
-	}
-	
-	// gets the current "Q" output
-	float Q() {
-		return boolToGate(stateQ);
-	}
-	
-	// gets the current not Q output
-	float NQ() {
-		return boolToGate(stateNQ);
-	}
-	
-	// gets the current "Q" output light value
-	float QLight() {
-		return boolToLight(stateQ);
+		for (int g = 0; g < PORT_MAX_CHANNELS / 4; g++) {
+			S[g].reset();
+			R[g].reset();
+			E[g].reset();
+		}
+		
+		LatchBank::reset();
 	}
-	
-	// gets the current not Q output light value
-	float NQLight() {
-		return boolToLight(stateNQ);
-	}	
 };
 
 struct SRFlipFlop : Module {
@@ -93,6 +71,9 @@ struct SRFlipFlop : Module {
 	};
 
 	SRLatch flipflop[2];
+	
+	// polyphonic mode - the flip flops handle as many channels as their inputs provide
+	bool polyphonic = false;
 
 	// add the variables we'll use when managing themes
 	#include "../themes/variables.hpp"
@@ -116,6 +97,7 @@ struct SRFlipFlop : Module {
 	void onReset() override {
 		flipflop[0].reset();
 		flipflop[1].reset();
+		polyphonic = false;
 	}
 
 
@@ -127,7 +109,7 @@ struct SRFlipFlop : Module {
 		// flip flop Q states
 		json_t *QStates = json_array();
 		for (int i = 0; i < 2; i++) {
-			json_array_insert_new(QStates, i, json_boolean(flipflop[i].stateQ));
+			json_array_insert_new(QStates, i, json_boolean(flipflop[i].stateQ & 0x01));
 		}
 		json_object_set_new(root, "QStates", QStates);
 
@@ -135,9 +117,21 @@ struct SRFlipFlop : Module {
 		// flip flop NQ states
 		json_t *NQStates = json_array();
 		for (int i = 0; i < 2; i++) {
-			json_array_insert_new(NQStates, i, json_boolean(flipflop[i].stateNQ));
+			json_array_insert_new(NQStates, i, json_boolean(flipflop[i].stateNQ & 0x01));
 		}
 		json_object_set_new(root, "NQStates", NQStates);
+
+		// polyphonic channel states
+		json_t *QBits = json_array();
+		json_t *NQBits = json_array();
+		for (int i = 0; i < 2; i++) {
+			json_array_insert_new(QBits, i, json_integer(flipflop[i].stateQ));
+			json_array_insert_new(NQBits, i, json_integer(flipflop[i].stateNQ));
+		}
+		json_object_set_new(root, "QBits", QBits);
+		json_object_set_new(root, "NQBits", NQBits);
+		
+		json_object_set_new(root, "polyphonic", json_boolean(polyphonic));
 		
 		// add the theme details
 		#include "../themes/dataToJson.hpp"		
@@ -154,7 +148,7 @@ struct SRFlipFlop : Module {
 			for (int i = 0; i < 2; i++) {
 				json_t *state = json_array_get(QStates, i);
 				
-				flipflop[i].stateQ = json_is_true(state);
+				flipflop[i].stateQ = (flipflop[i].stateQ & 0xfffe) | (json_is_true(state) ? 0x01 : 0x00);
 			}
 		}
 		
@@ -165,9 +159,25 @@ struct SRFlipFlop : Module {
 			for (int i = 0; i < 2; i++) {
 				json_t *state = json_array_get(NQStates, i);
 				
-				flipflop[i].stateNQ = json_is_true(state);
+				flipflop[i].stateNQ = (flipflop[i].stateNQ & 0xfffe) | (json_is_true(state) ? 0x01 : 0x00);
 			}
 		}
+
+		// polyphonic channel states
+		json_t *QBits = json_object_get(root, "QBits");
+		json_t *NQBits = json_object_get(root, "NQBits");
+		
+		for (int i = 0; i < 2; i++) {
+			if (QBits)
+				flipflop[i].stateQ = json_integer_value(json_array_get(QBits, i));
+			
+			if (NQBits)
+				flipflop[i].stateNQ = json_integer_value(json_array_get(NQBits, i));
+		}
+		
+		json_t *poly = json_object_get(root, "polyphonic");
+		if (poly)
+			polyphonic = json_boolean_value(poly);
 		
 		// grab the theme details
 		#include "../themes/dataFromJson.hpp"		
@@ -176,13 +186,21 @@ struct SRFlipFlop : Module {
 	void process(const ProcessArgs &args) override {
 		
 		for (int i = 0; i < 2; i++) {
+			// in polyphonic mode each flip flop handles as many channels as there are on its inputs
+			int n = polyphonic ? LatchBank::channels(inputs[S_INPUT + i], inputs[R_INPUT + i], inputs[ENABLE_INPUT + i]) : 1;
+			
 			//perform the latch logic with the given inputs
-			flipflop[i].process(inputs[S_INPUT + i].getVoltage(), inputs[R_INPUT + i].getVoltage(), inputs[ENABLE_INPUT + i].getNormalVoltage(10.0f));
+			flipflop[i].process(inputs[S_INPUT + i], inputs[R_INPUT + i], inputs[ENABLE_INPUT + i], n);
 			
 			// set outputs according to latch states
-			outputs[Q_OUTPUT + i].setVoltage(flipflop[i].Q());
+			outputs[Q_OUTPUT + i].setChannels(n);
+			outputs[NQ_OUTPUT + i].setChannels(n);
+			for (int c = 0; c < n; c += 4) {
+				outputs[Q_OUTPUT + i].setVoltageSimd(flipflop[i].Q(c), c);
+				outputs[NQ_OUTPUT + i].setVoltageSimd(flipflop[i].NQ(c), c);
+			}
+			
 			lights[STATE_LIGHT + i].setSmoothBrightness(flipflop[i].QLight(), args.sampleTime);
-			outputs[NQ_OUTPUT + i].setVoltage(flipflop[i].NQ());
 		}
 	}
 };
@@ -220,6 +238,15 @@ struct SRFlipFlopWidget : ModuleWidget {
 	// include the theme menu item struct we'll when we add the theme menu items
 	#include "../themes/ThemeMenuItem.hpp"
 
+	// polyphonic mode menu item
+	struct PolyphonicMenuItem : MenuItem {
+		SRFlipFlop *module;
+		
+		void onAction(const event::Action &e) override {
+			module->polyphonic ^= true;
+		}
+	};
+
 	void appendContextMenu(Menu *menu) override {
 		SRFlipFlop *module = dynamic_cast<SRFlipFlop*>(this->module);
 		assert(module);
@@ -229,6 +256,14 @@ struct SRFlipFlopWidget : ModuleWidget {
 		
 		// add the theme menu items
 		#include "../themes/themeMenus.hpp"
+		
+		menu->addChild(new MenuSeparator());
+		menu->addChild(createMenuLabel("Settings"));
+		
+		// add the polyphonic mode menu item
+		PolyphonicMenuItem *polyMenuItem = createMenuItem<PolyphonicMenuItem>("Polyphonic", CHECKMARK(module->polyphonic));
+		polyMenuItem->module = module;
+		menu->addChild(polyMenuItem);
 	}	
 	
 	void step() override {
@@ -270,6 +305,9 @@ struct SingleSRFlipFlop : Module {
 	};
 
 	SRLatch flipflop;
+	
+	// polyphonic mode - the flip flop handles as many channels as its inputs provide
+	bool polyphonic = false;
 
 	// add the variables we'll use when managing themes
 	#include "../themes/variables.hpp"
@@ -290,6 +328,7 @@ struct SingleSRFlipFlop : Module {
 	
 	void onReset() override {
 		flipflop.reset();
+		polyphonic = false;
 	}
 
 
@@ -299,8 +338,14 @@ struct SingleSRFlipFlop : Module {
 		json_object_set_new(root, "moduleVersion", json_integer(1));
 		
 		// flip flop states
-		json_object_set_new(root, "QState", json_boolean(flipflop.stateQ));
-		json_object_set_new(root, "NQState", json_boolean(flipflop.stateNQ));
+		json_object_set_new(root, "QState", json_boolean(flipflop.stateQ & 0x01));
+		json_object_set_new(root, "NQState", json_boolean(flipflop.stateNQ & 0x01));
+
+		// polyphonic channel states
+		json_object_set_new(root, "QBits", json_integer(flipflop.stateQ));
+		json_object_set_new(root, "NQBits", json_integer(flipflop.stateNQ));
+		
+		json_object_set_new(root, "polyphonic", json_boolean(polyphonic));
 		
 		// add the theme details
 		#include "../themes/dataToJson.hpp"		
@@ -315,24 +360,46 @@ struct SingleSRFlipFlop : Module {
 		json_t *NQState = json_object_get(root, "NQState");
 	
 		if (QState)
-			flipflop.stateQ = json_boolean_value(QState);
+			flipflop.stateQ = (flipflop.stateQ & 0xfffe) | (json_boolean_value(QState) ? 0x01 : 0x00);
 
 		if (NQState)
-			flipflop.stateNQ =  json_boolean_value(NQState);
+			flipflop.stateNQ = (flipflop.stateNQ & 0xfffe) | (json_boolean_value(NQState) ? 0x01 : 0x00);
+
+		// polyphonic channel states
+		json_t *QBits = json_object_get(root, "QBits");
+		json_t *NQBits = json_object_get(root, "NQBits");
+		
+		if (QBits)
+			flipflop.stateQ = json_integer_value(QBits);
+		
+		if (NQBits)
+			flipflop.stateNQ = json_integer_value(NQBits);
+		
+		json_t *poly = json_object_get(root, "polyphonic");
+		if (poly)
+			polyphonic = json_boolean_value(poly);
 		
 		// grab the theme details
 		#include "../themes/dataFromJson.hpp"		
 	}	
 
 	void process(const ProcessArgs &args) override {
+
+		// in polyphonic mode the flip flop handles as many channels as there are on its inputs
+		int n = polyphonic ? LatchBank::channels(inputs[S_INPUT], inputs[R_INPUT], inputs[ENABLE_INPUT]) : 1;
 		
 		//perform the latch logic
-		flipflop.process(inputs[S_INPUT].getVoltage(), inputs[R_INPUT].getVoltage(), inputs[ENABLE_INPUT].getNormalVoltage(10.0f));
+		flipflop.process(inputs[S_INPUT], inputs[R_INPUT], inputs[ENABLE_INPUT], n);
 		
 		// set outputs according to latch states
-		outputs[Q_OUTPUT].setVoltage(flipflop.Q());
+		outputs[Q_OUTPUT].setChannels(n);
+		outputs[NQ_OUTPUT].setChannels(n);
+		for (int c = 0; c < n; c += 4) {
+			outputs[Q_OUTPUT].setVoltageSimd(flipflop.Q(c), c);
+			outputs[NQ_OUTPUT].setVoltageSimd(flipflop.NQ(c), c);
+		}
+		
 		lights[Q_LIGHT].setSmoothBrightness(flipflop.QLight(), args.sampleTime);
-		outputs[NQ_OUTPUT].setVoltage(flipflop.NQ());
 		lights[NQ_LIGHT].setSmoothBrightness(flipflop.NQLight(), args.sampleTime);
 	}
 };
@@ -368,6 +435,15 @@ struct SingleSRFlipFlopWidget : ModuleWidget {
 	// include the theme menu item struct we'll when we add the theme menu items
 	#include "../themes/ThemeMenuItem.hpp"
 
+	// polyphonic mode menu item
+	struct PolyphonicMenuItem : MenuItem {
+		SingleSRFlipFlop *module;
+		
+		void onAction(const event::Action &e) override {
+			module->polyphonic ^= true;
+		}
+	};
+
 	void appendContextMenu(Menu *menu) override {
 		SingleSRFlipFlop *module = dynamic_cast<SingleSRFlipFlop*>(this->module);
 		assert(module);
@@ -377,6 +453,14 @@ struct SingleSRFlipFlopWidget : ModuleWidget {
 		
 		// add the theme menu items
 		#include "../themes/themeMenus.hpp"
+		
+		menu->addChild(new MenuSeparator());
+		menu->addChild(createMenuLabel("Settings"));
+		
+		// add the polyphonic mode menu item
+		PolyphonicMenuItem *polyMenuItem = createMenuItem<PolyphonicMenuItem>("Polyphonic", CHECKMARK(module->polyphonic));
+		polyMenuItem->module = module;
+		menu->addChild(polyMenuItem);
 	}	
 	
 	void step() override {
@@ -5,12 +5,14 @@
 //----------------------------------------------------------------------------
 #include "../CountModula.hpp"
 #include "../inc/Utility.hpp"
-#include "../inc/GateProcessor.hpp"
+#include "../inc/GateProcessorSimd.hpp"
 
 // set the module name for the theme selection functions
 #define THEME_MODULE_NAME SampleAndHold2
 #define PANEL_FILE "SampleAndHold2.svg"
 
+using simd::float_4;
+
 struct SampleAndHold2 : Module {
 	enum ParamIds {
 		MODE_PARAM,
@@ -46,12 +48,12 @@ struct SampleAndHold2 : Module {
 		PASS
 	};
 	
-	GateProcessor gateTrig[16];
+	GateProcessorSimd gateTrig[4];
 	int processCount = 8;
 	int trackMode = SAMPLE;
 	float probability = 100.0f;
 	float probabilityCV = 100.0f;
-	bool doSample[16] = {};
+	float_4 doSample[4] = {};
 	bool forceSample = true;
 	
 	// add the variables we'll use when managing themes
@@ -89,9 +91,9 @@ struct SampleAndHold2 : Module {
 	}
 	
 	void onReset() override {
-		for(int i = 0; i < 16; i++) {
-			gateTrig[i].reset();
-			doSample[i] = false;
+		for(int g = 0; g < 4; g++) {
+			gateTrig[g].reset();
+			doSample[g] = float_4::zero();
 		}
 			
 		processCount = 8;
@@ -107,7 +109,7 @@ struct SampleAndHold2 : Module {
 		
 		json_t *samp = json_array();
 		for(int i = 0; i < 16; i++) {
-			json_array_insert_new(samp, i, json_boolean(doSample[i]));
+			json_array_insert_new(samp, i, json_boolean(simd::movemask(doSample[i / 4]) & (1 << (i % 4))));
 		}
 
 		json_object_set_new(root, "sample", samp);
@@ -121,15 +123,28 @@ struct SampleAndHold2 : Module {
 		
 		json_t *samp = json_object_get(root, "sample");
 		
-		for(int i = 0; i < 16; i++) {
-			if (samp) {
+		if (samp) {
+			int bits = 0;
+			for(int i = 0; i < 16; i++) {
 				json_t *v = json_array_get(samp, i);
-				if (v)
-					doSample[i] = json_boolean_value(v);
+				if (v && json_boolean_value(v))
+					bits |= (1 << i);
 			}
+			
+			for(int g = 0; g < 4; g++)
+				doSample[g] = simd::movemaskInverse<float_4>((bits >> (g * 4)) & 0x0f);
 		}
 	}	
 	
+	// 4 random values at a time
+	float_4 randomBatch() {
+		float r[4];
+		for (int i = 0; i < 4; i++)
+			r[i] = random::uniform();
+			
+		return float_4::load(r);
+	}
+	
 	void process(const ProcessArgs &args) override {
 
 		// determine the mode - input takes precedence over switch
@@ -173,68 +188,71 @@ struct SampleAndHold2 : Module {
 			outputs[SAMPLE_OUTPUT].setChannels(channelsToUse);
 			outputs[INV_OUTPUT].setChannels(channelsToUse);
 
-			// handle single trigger here
-			int t = 0;
-			if (numTrigs == 1) {
-				gateTrig[0].set(inputs[TRIG_INPUT].getVoltage());
-				t = 0;
-			}
-			
-			// now sample away
-			float s;
+			// now sample away 4 channels at a time
 			bool getProb = inputs[PROB_INPUT].isConnected();
-			float threshold = probability;
+			float_4 threshold = probability;
+			float_4 passMode = (trackMode == PASS ? float_4::mask() : float_4::zero());
 			
-			for (int c = 0; c < 16; c++) {
+			for (int c = 0; c < 16; c += 4) {
+				int g = c / 4;
+				
 				if (c < channelsToUse) {
-					if (numTrigs > 1) {
-						gateTrig[c].set(inputs[TRIG_INPUT].getVoltage(c));
-						t = c;
-					}
+					// lanes for the channels we're using and the channels we have to make up with random values
+					float_4 active = simd::movemaskInverse<float_4>((((1 << channelsToUse) - 1) >> c) & 0x0f);
+					float_4 missing = simd::movemaskInverse<float_4>(((0xffff << inputChannels) >> c) & 0x0f);
+					
+					// a single trigger is applied to all channels
+					gateTrig[g].set(simd::ifelse(active, inputs[TRIG_INPUT].getPolyVoltageSimd<float_4>(c), 0.0f));
 
-					// probability check goes here
-					if (forceSample || gateTrig[t].anyEdge()) {
-						float r = random::uniform();
+					// probability check goes here - the random values are drawn for all 4 channels at once
+					float_4 trig = forceSample ? active : gateTrig[g].anyEdge() & active;
+					if (simd::movemask(trig)) {
+						float_4 r = randomBatch();
 						if(getProb)
-							threshold = clamp(probability + (inputs[PROB_INPUT].getPolyVoltage(c) * probabilityCV / 10.f), 0.f, 1.f);
+							threshold = simd::clamp(probability + (inputs[PROB_INPUT].getPolyVoltageSimd<float_4>(c) * probabilityCV / 10.f), 0.f, 1.f);
 
-						if (r < threshold) {
-							switch (trackMode) {
-								case TRACK:
-									doSample[c] = gateTrig[t].high();
-									break;
-								case SAMPLE:
-									doSample[c] = gateTrig[t].leadingEdge();
-									break;
-								case PASS:
-									doSample[c] = !gateTrig[t].high();
-									break;
-							}
+						float_4 sample;
+						switch (trackMode) {
+							case TRACK:
+								sample = gateTrig[g].high();
+								break;
+							case SAMPLE:
+								sample = gateTrig[g].leadingEdge();
+								break;
+							case PASS:
+							default:
+								sample = gateTrig[g].low();
+								break;
 						}
+						
+						doSample[g] = simd::ifelse(trig & (r < threshold), sample, doSample[g]);
 					}
 
-					if (doSample[c]) {
-						// track, pass  or sample the input
-						float offsetVoltage = offset * inputs[OFFSET_INPUT].getNormalPolyVoltage(10.0f, c);
-						float v = c >= inputChannels ? random::uniform() * 10.0f - 5.0f : inputs[SAMPLE_INPUT].getVoltage(c);
-						// todo: saturate rather than clamp
-						s = clamp (v * level + offsetVoltage, -12.0f, 12.0f);
+					// track, pass  or sample the input
+					float_4 offsetVoltage = offset * inputs[OFFSET_INPUT].getNormalPolyVoltageSimd<float_4>(10.0f, c);
+					float_4 v = inputs[SAMPLE_INPUT].getVoltageSimd<float_4>(c);
+					if (simd::movemask(missing & doSample[g]))
+						v = simd::ifelse(missing, randomBatch() * 10.0f - 5.0f, v);
 						
-						if (trackMode == SAMPLE)
-							doSample[c] = false;
-					}
-					else {
-						// hold the last sample value
-						s = outputs[SAMPLE_OUTPUT].getVoltage(c);
-					}
+					// todo: saturate rather than clamp
+					float_4 s = simd::clamp(v * level + offsetVoltage, -12.0f, 12.0f);
+					
+					// otherwise hold the last sample value
+					s = simd::ifelse(doSample[g], s, outputs[SAMPLE_OUTPUT].getVoltageSimd<float_4>(c));
+					
+					if (trackMode == SAMPLE)
+						doSample[g] = float_4::zero();
+					
+					// channels we're not using are ready to pass as soon as they're needed
+					doSample[g] = simd::ifelse(active, doSample[g], passMode);
 					
 					// set the output voltages
-					outputs[SAMPLE_OUTPUT].setVoltage(s, c);
-					outputs[INV_OUTPUT].setVoltage(-s, c);
+					outputs[SAMPLE_OUTPUT].setVoltageSimd(s, c);
+					outputs[INV_OUTPUT].setVoltageSimd(-s, c);
 				}
 				else {
-					doSample[c] = trackMode == PASS;
-					gateTrig[c].set(0.0f);
+					doSample[g] = passMode;
+					gateTrig[g].set(0.0f);
 				}
 			}
 			
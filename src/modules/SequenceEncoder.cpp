@@ -51,7 +51,7 @@ struct SequenceEncoder : Module {
 	// add the variables we'll use when managing themes
 	#include "../themes/variables.hpp"
 	
-	SequencerChannelMessage rightMessages[2][1]; // messages to right module (expander)
+	ExpanderChain<SequencerChannelMessage> expanderChain;	// expanders driven directly from this module
 
 	SequenceEncoder() {
 		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
@@ -65,10 +65,6 @@ struct SequenceEncoder : Module {
 		inputInfos[A0_INPUT]->description = "Least significant bit";
 		inputInfos[A3_INPUT]->description = "Most significant bit";
 
-		// expander
-		rightExpander.producerMessage = rightMessages[0];
-		rightExpander.consumerMessage = rightMessages[1];	
-
 		// set the theme from the current default value
 		#include "../themes/setDefaultTheme.hpp"
 		
@@ -109,6 +105,11 @@ struct SequenceEncoder : Module {
 		length = SEQ_NUM_STEPS;
 	}
 
+	// any change in the layout means the expander chain needs to be resolved again
+	void onExpanderChange(const ExpanderChangeEvent &e) override {
+		expanderChainGeneration()++;
+	}
+	
 	void process(const ProcessArgs &args) override {
 
 		// process the clock
@@ -149,13 +150,12 @@ struct SequenceEncoder : Module {
 		}
 
 		// set up details for the expander
-		if (rightExpander.module) {
-			if (isExpanderModule(rightExpander.module)) {
-				SequencerChannelMessage *messageToExpander = (SequencerChannelMessage*)(rightExpander.module->leftExpander.producerMessage);
-				messageToExpander->set(count, length, gateClock.high(), true, 1, true); // always running
+		if (expanderChain.resolve(this, isSequencerChannelExpander)) {
+			SequencerChannelMessage *messageToExpander = &expanderChain.message;
+			messageToExpander->set(count, length, gateClock.high(), true, 1, true); // always running
 
-				rightExpander.module->leftExpander.messageFlipRequested = true;
-			}
+			// drive the expanders directly so the whole chain sees this sample
+			expanderChain.process(args);
 		}
 	}
 };
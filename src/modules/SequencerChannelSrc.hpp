@@ -2,7 +2,7 @@
 //	/^M^\ Count Modula Plugin for VCV Rack - Standard Sequencer Channel Engine
 //	Copyright (C) 2020  Adam Verspaget
 //----------------------------------------------------------------------------
-struct STRUCT_NAME : Module {
+struct STRUCT_NAME : ChainedExpander<SequencerChannelMessage> {
 
 	enum ParamIds {
 		ENUMS(STEP_PARAMS, SEQ_NUM_STEPS),
@@ -48,9 +48,7 @@ struct STRUCT_NAME : Module {
 	bool prevGate = false;
 
 	// Expander details
-	SequencerChannelMessage leftMessages[2][1];	// messages from left module (master)
-	SequencerChannelMessage rightMessages[2][1]; // messages to right module (expander)
-	SequencerChannelMessage *messagesFromMaster;
+	SequencerChannelMessage *messagesFromMaster = NULL;
 	
 	// add the variables we'll use when managing themes
 	#include "../themes/variables.hpp"
@@ -80,13 +78,9 @@ struct STRUCT_NAME : Module {
 		// set the theme from the current default value
 		#include "../themes/setDefaultTheme.hpp"
 		
-		// from left module (master)
-		leftExpander.producerMessage = leftMessages[0];
-		leftExpander.consumerMessage = leftMessages[1];		
-		
-		// to right module (expander)
-		rightExpander.producerMessage = rightMessages[0];
-		rightExpander.consumerMessage = rightMessages[1];	
+		// expander chain family
+		isChainExpander = isSequencerChannelExpander;
+		isChainMaster = isSequencerChannelMaster;
 	}
 	
 	json_t *dataToJson() override {
@@ -137,7 +131,7 @@ struct STRUCT_NAME : Module {
 		doRedraw = true;
 	}
 
-	void process(const ProcessArgs &args) override {
+	void processExpander(const ProcessArgs &args, SequencerChannelMessage *message) override {
 
 		bool running = false;
 		bool clock = false;
@@ -145,27 +139,23 @@ struct STRUCT_NAME : Module {
 
 		// grab the detail from the left hand module if we have one
 		currentChannel = 0;
-		messagesFromMaster = 0; 
-		if (leftExpander.module) {
-			if (isExpanderModule(leftExpander.module) || isExpandableModule(leftExpander.module)) {
-					
-				messagesFromMaster = (SequencerChannelMessage *)(leftExpander.consumerMessage);
-
-				count = messagesFromMaster->counter;
-				length = messagesFromMaster->length;
-				running = messagesFromMaster->runningState;
-				clock = messagesFromMaster->clockState;
+		messagesFromMaster = message; 
+		if (messagesFromMaster) {
 				
-				// for the binary addressed sequencer, we need to chop off the 4th bit if we're running an 8 step channel
-				if (count > SEQ_NUM_STEPS)
-					count -= SEQ_NUM_STEPS;
+			count = messagesFromMaster->counter;
+			length = messagesFromMaster->length;
+			running = messagesFromMaster->runningState;
+			clock = messagesFromMaster->clockState;
+			
+			// for the binary addressed sequencer, we need to chop off the 4th bit if we're running an 8 step channel
+			if (count > SEQ_NUM_STEPS)
+				count -= SEQ_NUM_STEPS;
 
-				if (userChannel == 0)
-					userChannel = messagesFromMaster->channel;
-				
-				if (messagesFromMaster->hasMaster)
-					currentChannel = userChannel;
-			}
+			if (userChannel == 0)
+				userChannel = messagesFromMaster->channel;
+			
+			if (messagesFromMaster->hasMaster)
+				currentChannel = userChannel;
 		}
 		
 		if (currentChannel != prevChannel) {
@@ -224,29 +214,17 @@ struct STRUCT_NAME : Module {
 		
 		prevGate = gate;
 		
-		// finally set up the details for any secondary expander
-		if (rightExpander.module) {
-			if (isExpanderModule(rightExpander.module)) {
-				
-				SequencerChannelMessage *messageToExpander = (SequencerChannelMessage*)(rightExpander.module->leftExpander.producerMessage);
-				
-				if (messagesFromMaster) {
-					int ch = 0;
-					if (messagesFromMaster->hasMaster) {
-						ch = messagesFromMaster->channel;
+		// finally set up the details for the next expander along
+		if (messagesFromMaster) {
+			int ch = 0;
+			if (messagesFromMaster->hasMaster) {
+				ch = messagesFromMaster->channel;
 
-						if (++ch > 7)
-							ch = 1;
-					}
-						
-					messageToExpander->set(count, length, clock, running, ch, messagesFromMaster->hasMaster);
-				}
-				else {
-					messageToExpander->initialise();
-				}
-
-				rightExpander.module->leftExpander.messageFlipRequested = true;
+				if (++ch > 7)
+					ch = 1;
 			}
+				
+			messagesFromMaster->set(count, length, clock, running, ch, messagesFromMaster->hasMaster);
 		}			
 	}
 };
@@ -14,7 +14,7 @@
 #define THEME_MODULE_NAME SequencerExpanderCV8
 #define PANEL_FILE "SequencerExpanderCV8.svg"
 
-struct SequencerExpanderCV8 : Module {
+struct SequencerExpanderCV8 : SequencerExpander {
 
 	enum ParamIds {
 		ENUMS(STEP_CV_PARAMS, SEQ_NUM_STEPS),
@@ -40,9 +40,7 @@ struct SequencerExpanderCV8 : Module {
 	
 	// Expander details
 	int ExpanderID = SequencerExpanderMessage::CV8;
-	SequencerExpanderMessage leftMessages[2][1];	// messages from left module (master)
-	SequencerExpanderMessage rightMessages[2][1]; // messages to right module (expander)
-	SequencerExpanderMessage *messagesFromMaster;
+	SequencerExpanderMessage *messagesFromMaster = NULL;
 	
 	int channelID = -1;
 	int prevChannelID = -1;
@@ -62,14 +60,6 @@ struct SequencerExpanderCV8 : Module {
 	SequencerExpanderCV8() {
 		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
 		
-		// from left module (master)
-		leftExpander.producerMessage = leftMessages[0];
-		leftExpander.consumerMessage = leftMessages[1];		
-		
-		// to right module (expander)
-		rightExpander.producerMessage = rightMessages[0];
-		rightExpander.consumerMessage = rightMessages[1];	
-		
 		// step params
 		for (int s = 0; s < SEQ_NUM_STEPS; s++) {
 			configParam(STEP_CV_PARAMS + s, 0.0f, 8.0f, 0.0f, "Step value");
@@ -114,52 +104,46 @@ struct SequencerExpanderCV8 : Module {
 		}
 	}
 
-	void process(const ProcessArgs &args) override {
+	void processExpander(const ProcessArgs &args, SequencerExpanderMessage *message) override {
 
 		// details from master
 		int count = 0;
 		int channelCounters[SEQUENCER_EXP_MAX_CHANNELS] = {0, 0, 0, 0};
-		bool clockStates[SEQUENCER_EXP_MAX_CHANNELS] = {false, false, false, false};
-		bool runningStates[SEQUENCER_EXP_MAX_CHANNELS] = {false, false, false, false};
 		
 		colourMap = colourMapDefault;
 		
-		// grab the detail from the left hand module if we have one
+		// grab the detail from the master if we have one
+		messagesFromMaster = message;
 		leftModuleAvailable = false;
-		if (leftExpander.module) {
-			if (isExpanderModule(leftExpander.module) || isExpandableModule(leftExpander.module)) {
-					
-				leftModuleAvailable = true;
-				messagesFromMaster = (SequencerExpanderMessage *)(leftExpander.consumerMessage);
-
-				switch (messagesFromMaster->masterModule) {
-					case SEQUENCER_EXP_MASTER_MODULE_BINARY:
-						colourMap = colourMapBinSeq;
-						break;
-					case SEQUENCER_EXP_MASTER_MODULE_DUALSTEP:
-						colourMap = colourMapSS;
-						break;
-					default:
-						colourMap = colourMapDefault;
-						break;
-				}
+		if (messagesFromMaster) {
 				
-				// grab the channel id for this expander type
-				channelID = clamp(messagesFromMaster->channels[ExpanderID], -1, 3);
+			leftModuleAvailable = true;
 
-				// decode the counter array
-				for(int i = 0; i < SEQUENCER_EXP_MAX_CHANNELS; i++) {
-					channelCounters[i] = messagesFromMaster->counters[i];
-					clockStates[i] = messagesFromMaster->clockStates[i];
-					runningStates[i] = messagesFromMaster->runningStates[i];
-					
-					if (i == channelID) {
-						count = std::max(channelCounters[i], 0);
+			switch (messagesFromMaster->masterModule) {
+				case SEQUENCER_EXP_MASTER_MODULE_BINARY:
+					colourMap = colourMapBinSeq;
+					break;
+				case SEQUENCER_EXP_MASTER_MODULE_DUALSTEP:
+					colourMap = colourMapSS;
+					break;
+				default:
+					colourMap = colourMapDefault;
+					break;
+			}
 			
-						// wrap counters > 8 back around to 1 - for the gated comparator, we'll just treat the shift register like a counter
-						while (count > SEQ_NUM_STEPS)
-							count -= SEQ_NUM_STEPS;
-					}
+			// grab the channel id for this expander type
+			channelID = clamp(messagesFromMaster->channels[ExpanderID], -1, 3);
+
+			// decode the counter array
+			for(int i = 0; i < SEQUENCER_EXP_MAX_CHANNELS; i++) {
+				channelCounters[i] = messagesFromMaster->counters[i];
+				
+				if (i == channelID) {
+					count = std::max(channelCounters[i], 0);
+		
+					// wrap counters > 8 back around to 1 - for the gated comparator, we'll just treat the shift register like a counter
+					while (count > SEQ_NUM_STEPS)
+						count -= SEQ_NUM_STEPS;
 				}
 			}
 		}
@@ -205,42 +189,9 @@ struct SequencerExpanderCV8 : Module {
 		outputs[CV_OUTPUT].setVoltage(cv);
 		outputs[CVI_OUTPUT].setVoltage(-cv);
 		
-		// set up the detail for any secondary expander
-		if (rightExpander.module) {
-			if (isExpanderModule(rightExpander.module)) {
-				
-				SequencerExpanderMessage *messageToExpander = (SequencerExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
-				
-				// set next module's channel number
-				if (channelID < 0) {
-					// we have no left hand module
-					messageToExpander->setDefaultValues();
-				}
-				else {
-					// set the channel for the next expander of this type
-					messageToExpander->setNextChannel(channelID, ExpanderID);
-					
-					// add the channel counters and gate states
-					for (int i = 0; i < SEQUENCER_EXP_MAX_CHANNELS ; i++) {
-						messageToExpander->counters[i] = channelCounters[i];
-						messageToExpander->clockStates[i] = clockStates[i];
-						messageToExpander->runningStates[i] = runningStates[i];
-					}
-					
-					// pass through the other expander channel numbers and master module details
-					if (messagesFromMaster) {
-						for(int i = 0; i < SequencerExpanderMessage::NUM_EXPANDERS; i++) {
-							if (i != ExpanderID)
-								messageToExpander->setChannel(messagesFromMaster->channels[i], i);
-						}
-						
-						messageToExpander->masterModule = messagesFromMaster->masterModule;
-					}
-				}
-
-				rightExpander.module->leftExpander.messageFlipRequested = true;
-			}
-		}			
+		// set the channel for the next expander of this type
+		if (messagesFromMaster)
+			messagesFromMaster->setNextChannel(channelID, ExpanderID);
 	}
 };
 
@@ -14,7 +14,7 @@
 #define THEME_MODULE_NAME SequencerExpanderLog8
 #define PANEL_FILE "SequencerExpanderLog8.svg"
 
-struct SequencerExpanderLog8 : Module {
+struct SequencerExpanderLog8 : SequencerExpander {
 
 	enum ParamIds {
 		ENUMS(BIT_PARAMS, SEQ_NUM_STEPS),
@@ -43,9 +43,7 @@ struct SequencerExpanderLog8 : Module {
 	
 	// Expander details
 	int ExpanderID = SequencerExpanderMessage::LOG8;
-	SequencerExpanderMessage leftMessages[2][1];	// messages from left module (master)
-	SequencerExpanderMessage rightMessages[2][1]; // messages to right module (expander)
-	SequencerExpanderMessage *messagesFromMaster;
+	SequencerExpanderMessage *messagesFromMaster = NULL;
 	
 	int channelID = -1;
 	int prevChannelID = -1;
@@ -65,14 +63,6 @@ struct SequencerExpanderLog8 : Module {
 	SequencerExpanderLog8() {
 		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
 		
-		// from left module (master)
-		leftExpander.producerMessage = leftMessages[0];
-		leftExpander.consumerMessage = leftMessages[1];		
-		
-		// to right module (expander)
-		rightExpander.producerMessage = rightMessages[0];
-		rightExpander.consumerMessage = rightMessages[1];	
-		
 		// bit params
 		for (int s = 0; s < SEQ_NUM_STEPS; s++) {
 			configButton(BIT_PARAMS + s, rack::string::f("Bit %d", s + 1));
@@ -106,7 +96,7 @@ struct SequencerExpanderLog8 : Module {
 		#include "../themes/dataFromJson.hpp"
 	}	
 	
-	void process(const ProcessArgs &args) override {
+	void processExpander(const ProcessArgs &args, SequencerExpanderMessage *message) override {
 
 		// details from master
 		bool running = true;
@@ -118,57 +108,55 @@ struct SequencerExpanderLog8 : Module {
 		
 		colourMap = colourMapDefault;
 		
-		// grab the detail from the left hand module if we have one
+		// grab the detail from the master if we have one
+		messagesFromMaster = message;
 		leftModuleAvailable = false;
-		if (leftExpander.module) {
-			if (isExpanderModule(leftExpander.module) || isExpandableModule(leftExpander.module)) {		
-				
-				leftModuleAvailable = true;
-				messagesFromMaster = (SequencerExpanderMessage *)(leftExpander.consumerMessage);
-
-				switch (messagesFromMaster->masterModule) {
-					case SEQUENCER_EXP_MASTER_MODULE_BINARY:
-						colourMap = colourMapBinSeq;
-						break;
-					case SEQUENCER_EXP_MASTER_MODULE_DUALSTEP:
-						colourMap = colourMapSS;
-						break;
-					default:
-						colourMap = colourMapDefault;
-						break;
-				}
-				
-				// grab the channel id for this expander type
-				channelID = clamp(messagesFromMaster->channels[ExpanderID], -1, 3);
+		if (messagesFromMaster) {	
+			
+			leftModuleAvailable = true;
 
-				// decode the counter array
-				for(int i = 0; i < SEQUENCER_EXP_MAX_CHANNELS; i++) {
-					shiftRegisters[i] = messagesFromMaster->counters[i];
-					clockStates[i] = messagesFromMaster->clockStates[i];
-					runningStates[i] = messagesFromMaster->runningStates[i];
+			switch (messagesFromMaster->masterModule) {
+				case SEQUENCER_EXP_MASTER_MODULE_BINARY:
+					colourMap = colourMapBinSeq;
+					break;
+				case SEQUENCER_EXP_MASTER_MODULE_DUALSTEP:
+					colourMap = colourMapSS;
+					break;
+				default:
+					colourMap = colourMapDefault;
+					break;
+			}
 			
-					if (i == channelID) {
-						clock = clockStates[i];
-						running = runningStates[i];
+			// grab the channel id for this expander type
+			channelID = clamp(messagesFromMaster->channels[ExpanderID], -1, 3);
 
-						if (messagesFromMaster->masterModule == SEQUENCER_EXP_MASTER_MODULE_GATEDCOMPARATOR || messagesFromMaster->masterModule == SEQUENCER_EXP_MASTER_MODULE_BINARY) {
-							// shift register or full scale counter based master - can use the value we're given
-							shiftRegister = std::max(shiftRegisters[i], 0) & 0xFF;
-						}
-						else {
-							// for non shift register or 8/16 step based sources, we need to translate the counter into a shift register value
-							int count = std::max(shiftRegisters[i], 0);
-							
-							while (count > SEQ_NUM_STEPS)
-								count -= SEQ_NUM_STEPS;
+			// decode the counter array
+			for(int i = 0; i < SEQUENCER_EXP_MAX_CHANNELS; i++) {
+				shiftRegisters[i] = messagesFromMaster->counters[i];
+				clockStates[i] = messagesFromMaster->clockStates[i];
+				runningStates[i] = messagesFromMaster->runningStates[i];
+		
+				if (i == channelID) {
+					clock = clockStates[i];
+					running = runningStates[i];
+
+					if (messagesFromMaster->masterModule == SEQUENCER_EXP_MASTER_MODULE_GATEDCOMPARATOR || messagesFromMaster->masterModule == SEQUENCER_EXP_MASTER_MODULE_BINARY) {
+						// shift register or full scale counter based master - can use the value we're given
+						shiftRegister = std::max(shiftRegisters[i], 0) & 0xFF;
+					}
+					else {
+						// for non shift register or 8/16 step based sources, we need to translate the counter into a shift register value
+						int count = std::max(shiftRegisters[i], 0);
+						
+						while (count > SEQ_NUM_STEPS)
+							count -= SEQ_NUM_STEPS;
 
-							if (count > 0) {
-								// adjust 1-8 down to 0-7
-								count--;
-							
-								// now convert to shift register
-								shiftRegister = 0x01 << count;
-							}
+						if (count > 0) {
+							// adjust 1-8 down to 0-7
+							count--;
+						
+							// now convert to shift register
+							shiftRegister = 0x01 << count;
 						}
 					}
 				}
@@ -235,41 +223,9 @@ struct SequencerExpanderLog8 : Module {
 		lights[AND_LIGHT].setBrightness(boolToLight(outAND));	
 		lights[OR_LIGHT].setBrightness(boolToLight(outOR));
 		
-		// set up the detail for any secondary expander
-		if (rightExpander.module) {
-			if (isExpanderModule(rightExpander.module)) {
-				
-				SequencerExpanderMessage *messageToExpander = (SequencerExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
-				
-				// set next module's channel number
-				if (channelID < 0) {
-					// we have no left hand module
-					messageToExpander->setDefaultValues();
-				}
-				else {
-					// add the channel counters and gate states
-					for (int i = 0; i < SEQUENCER_EXP_MAX_CHANNELS ; i++) {
-						messageToExpander->counters[i] = shiftRegisters[i];
-						messageToExpander->clockStates[i] = clockStates[i];
-						messageToExpander->runningStates[i] = runningStates[i];
-					}
-					
-					// pass through the other expander channel numbers and master module details
-					if (messagesFromMaster) {
-						for(int i = 0; i < SequencerExpanderMessage::NUM_EXPANDERS; i++) {
-							messageToExpander->setChannel(messagesFromMaster->channels[i], i);
-						}
-						
-						messageToExpander->masterModule = messagesFromMaster->masterModule;
-					}
-					
-					// set the channel for the next expander of this type
-					messageToExpander->setNextChannel(channelID, ExpanderID);
-				}
-
-				rightExpander.module->leftExpander.messageFlipRequested = true;
-			}
-		}			
+		// set the channel for the next expander of this type
+		if (messagesFromMaster)
+			messagesFromMaster->setNextChannel(channelID, ExpanderID);
 	}
 };
 
@@ -15,7 +15,7 @@
 #define PANEL_FILE "SequencerExpanderOut8.svg"
 
 
-struct SequencerExpanderOut8 : Module {
+struct SequencerExpanderOut8 : SequencerExpander {
 
 	enum ParamIds {
 		MODE_PARAM,
@@ -39,9 +39,7 @@ struct SequencerExpanderOut8 : Module {
 	
 	// Expander details
 	int ExpanderID = SequencerExpanderMessage::OUT8;
-	SequencerExpanderMessage leftMessages[2][1];	// messages from left module (master)
-	SequencerExpanderMessage rightMessages[2][1]; // messages to right module (expander)
-	SequencerExpanderMessage *messagesFromMaster;
+	SequencerExpanderMessage *messagesFromMaster = NULL;
 	
 	int channelID = -1;
 	int prevChannelID = -1;
@@ -61,14 +59,6 @@ struct SequencerExpanderOut8 : Module {
 	SequencerExpanderOut8() {
 		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
 		
-		// from left module (master)
-		leftExpander.producerMessage = leftMessages[0];
-		leftExpander.consumerMessage = leftMessages[1];		
-		
-		// to right module (expander)
-		rightExpander.producerMessage = rightMessages[0];
-		rightExpander.consumerMessage = rightMessages[1];	
-		
 		// mode switch
 		configSwitch(MODE_PARAM, 0.0f, 1.0f, 0.0f, "Mode", {"Gate", "Trigger"});
 
@@ -97,7 +87,7 @@ struct SequencerExpanderOut8 : Module {
 		#include "../themes/dataFromJson.hpp"
 	}	
 	
-	void process(const ProcessArgs &args) override {
+	void processExpander(const ProcessArgs &args, SequencerExpanderMessage *message) override {
 
 		// details from master
 		bool running = true;
@@ -109,45 +99,43 @@ struct SequencerExpanderOut8 : Module {
 		
 		colourMap = colourMapDefault;
 		
-		// grab the detail from the left hand module if we have one
+		// grab the detail from the master if we have one
+		messagesFromMaster = message;
 		leftModuleAvailable = false;
-		if (leftExpander.module) {
-			if (isExpanderModule(leftExpander.module) || isExpandableModule(leftExpander.module)) {
-					
-				leftModuleAvailable = true;
-				messagesFromMaster = (SequencerExpanderMessage *)(leftExpander.consumerMessage);
-
-				switch (messagesFromMaster->masterModule) {
-					case SEQUENCER_EXP_MASTER_MODULE_BINARY:
-						colourMap = colourMapBinSeq;
-						break;
-					case SEQUENCER_EXP_MASTER_MODULE_DUALSTEP:
-						colourMap = colourMapSS;
-						break;
-					default:
-						colourMap = colourMapDefault;
-						break;
-				}
+		if (messagesFromMaster) {
 				
-				// grab the channel id for this expander type
-				channelID = clamp(messagesFromMaster->channels[ExpanderID], -1, 3);
-
-				// decode the counter array
-				for(int i = 0; i < SEQUENCER_EXP_MAX_CHANNELS; i++) {
-					channelCounters[i] = messagesFromMaster->counters[i];
-					clockStates[i] = messagesFromMaster->clockStates[i];
-					runningStates[i] = messagesFromMaster->runningStates[i];
+			leftModuleAvailable = true;
+
+			switch (messagesFromMaster->masterModule) {
+				case SEQUENCER_EXP_MASTER_MODULE_BINARY:
+					colourMap = colourMapBinSeq;
+					break;
+				case SEQUENCER_EXP_MASTER_MODULE_DUALSTEP:
+					colourMap = colourMapSS;
+					break;
+				default:
+					colourMap = colourMapDefault;
+					break;
+			}
+			
+			// grab the channel id for this expander type
+			channelID = clamp(messagesFromMaster->channels[ExpanderID], -1, 3);
+
+			// decode the counter array
+			for(int i = 0; i < SEQUENCER_EXP_MAX_CHANNELS; i++) {
+				channelCounters[i] = messagesFromMaster->counters[i];
+				clockStates[i] = messagesFromMaster->clockStates[i];
+				runningStates[i] = messagesFromMaster->runningStates[i];
+				
+				 if (i == channelID) {
+					count = std::max(channelCounters[i], 0);
+					clock = clockStates[i];
+					running = runningStates[i];
 					
-					 if (i == channelID) {
-						count = std::max(channelCounters[i], 0);
-						clock = clockStates[i];
-						running = runningStates[i];
-						
-						// wrap counters > 8 back around to 1 for the sequencers
-						if (messagesFromMaster->masterModule != SEQUENCER_EXP_MASTER_MODULE_GATEDCOMPARATOR) {
-							while (count > SEQ_NUM_STEPS)
-								count -= SEQ_NUM_STEPS;
-						}
+					// wrap counters > 8 back around to 1 for the sequencers
+					if (messagesFromMaster->masterModule != SEQUENCER_EXP_MASTER_MODULE_GATEDCOMPARATOR) {
+						while (count > SEQ_NUM_STEPS)
+							count -= SEQ_NUM_STEPS;
 					}
 				}
 			}
@@ -196,41 +184,9 @@ struct SequencerExpanderOut8 : Module {
 			outputs[STEP_GATE_OUTPUTS + c].setVoltage(boolToGate(stepActive && clock && running));
 		}
 
-		// set up the detail for any secondary expander
-		if (rightExpander.module) {
-			if (isExpanderModule(rightExpander.module)) {
-				
-				SequencerExpanderMessage *messageToExpander = (SequencerExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
-				
-				// set next module's channel number
-				if (channelID < 0) {
-					// we have no left hand module
-					messageToExpander->setDefaultValues();
-				}
-				else {
-					// add the channel counters and gate states
-					for (int i = 0; i < SEQUENCER_EXP_MAX_CHANNELS ; i++) {
-						messageToExpander->counters[i] = channelCounters[i];
-						messageToExpander->clockStates[i] = clockStates[i];
-						messageToExpander->runningStates[i] = runningStates[i];
-					}
-					
-					// pass through the other expander channel numbers and master module details
-					if (messagesFromMaster) {
-						for(int i = 0; i < SequencerExpanderMessage::NUM_EXPANDERS; i++) {
-								messageToExpander->setChannel(messagesFromMaster->channels[i], i);
-						}
-
-						messageToExpander->masterModule = messagesFromMaster->masterModule;
-					}
-					
-					// set the channel for the next expander of this type
-					messageToExpander->setNextChannel(channelID, ExpanderID);
-				}
-
-				rightExpander.module->leftExpander.messageFlipRequested = true;
-			}
-		}			
+		// set the channel for the next expander of this type
+		if (messagesFromMaster)
+			messagesFromMaster->setNextChannel(channelID, ExpanderID);
 	}
 };
 
@@ -11,7 +11,7 @@
 #define THEME_MODULE_NAME SequencerExpanderTSG
 #define PANEL_FILE "SequencerExpanderTSG.svg"
 
-struct SequencerExpanderTSG : Module {
+struct SequencerExpanderTSG : SequencerExpander {
 
 	enum ParamIds {
 		NUM_PARAMS
@@ -32,9 +32,7 @@ struct SequencerExpanderTSG : Module {
 	};
 	
 	// Expander details
-	SequencerExpanderMessage leftMessages[2][1];	// messages from left module (master)
-	SequencerExpanderMessage rightMessages[2][1]; // messages to right module (expander)
-	SequencerExpanderMessage *messagesFromMaster;
+	SequencerExpanderMessage *messagesFromMaster = NULL;
 	
 	bool leftModuleAvailable = false; 
 	
@@ -51,14 +49,6 @@ struct SequencerExpanderTSG : Module {
 			configOutput(GATE_OUTPUTS + i, rack::string::f("Gate %c", c++));
 		}
 		
-		// from left module (master)
-		leftExpander.producerMessage = leftMessages[0];
-		leftExpander.consumerMessage = leftMessages[1];		
-		
-		// to right module (expander)
-		rightExpander.producerMessage = rightMessages[0];
-		rightExpander.consumerMessage = rightMessages[1];	
-
 		// set the theme from the current default value
 		#include "../themes/setDefaultTheme.hpp"
 	}
@@ -79,20 +69,23 @@ struct SequencerExpanderTSG : Module {
 		#include "../themes/dataFromJson.hpp"
 	}	
 	
-	void process(const ProcessArgs &args) override {
+	// the gate expander only works when placed immediately to the right of a trigger sequencer
+	bool chainsFrom(Module *left) override {
+		return left->model == modelTriggerSequencer8 || left->model == modelTriggerSequencer16;
+	}
+	
+	void processExpander(const ProcessArgs &args, SequencerExpanderMessage *message) override {
 
 		for (int i = 0; i < SEQUENCER_EXP_NUM_TRIGGER_OUTS; i++)
 			gateValues[i] = false;
 	
-		// grab the detail from the left hand module if we have one
+		// grab the detail from the master if we have one
+		messagesFromMaster = message;
 		leftModuleAvailable = false;
-		if (leftExpander.module) {
-			if (leftExpander.module->model == modelTriggerSequencer8 || leftExpander.module->model == modelTriggerSequencer16) {
-				leftModuleAvailable = true;
-				messagesFromMaster = (SequencerExpanderMessage *)(leftExpander.consumerMessage);
-				for (int i = 0; i < SEQUENCER_EXP_NUM_TRIGGER_OUTS; i++)
-						gateValues[i] = messagesFromMaster->gateStates[i];
-			}
+		if (messagesFromMaster) {
+			leftModuleAvailable = true;
+			for (int i = 0; i < SEQUENCER_EXP_NUM_TRIGGER_OUTS; i++)
+				gateValues[i] = messagesFromMaster->gateStates[i];
 		}
 
 		// set the lights and outputs
@@ -101,33 +94,7 @@ struct SequencerExpanderTSG : Module {
 			outputs[GATE_OUTPUTS + i].setVoltage(boolToGate(gateValues[i]));
 		}
 		
-		// set up the detail for any secondary expander - don;t bother about the gate expander as there can be only one
-		if (rightExpander.module) {
-			if (isExpanderModule(rightExpander.module)) {
-				
-				SequencerExpanderMessage *messageToExpander = (SequencerExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
-				
-				// just pass the message through - the gate expander does not use any of the other expander values
-				if (leftModuleAvailable) {
-					for(int i = 0; i < SequencerExpanderMessage::NUM_EXPANDERS; i++)
-						messageToExpander->setChannel(messagesFromMaster->channels[i], i);
-					
-					for(int i = 0; i < SEQUENCER_EXP_MAX_CHANNELS; i++) {
-						messageToExpander->counters[i] = messagesFromMaster->counters[i];
-						messageToExpander->clockStates[i] = messagesFromMaster->clockStates[i];
-						messageToExpander->runningStates[i] = messagesFromMaster->runningStates[i];
-					}
-					
-					messageToExpander->masterModule = messagesFromMaster->masterModule;
-				}
-				else {
-					// we have no left hand module
-					messageToExpander->setDefaultValues();
-				}
-
-				rightExpander.module->leftExpander.messageFlipRequested = true;
-			}
-		}			
+		// the message is passed through untouched - the gate expander does not use any of the other expander values
 	}
 };
 
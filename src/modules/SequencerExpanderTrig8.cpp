@@ -14,7 +14,7 @@
 #define THEME_MODULE_NAME SequencerExpanderTrig8
 #define PANEL_FILE "SequencerExpanderTrig8.svg"
 
-struct SequencerExpanderTrig8 : Module {
+struct SequencerExpanderTrig8 : SequencerExpander {
 
 	enum ParamIds {
 		ENUMS(STEP_SW_PARAMS, SEQ_NUM_STEPS),
@@ -45,9 +45,7 @@ struct SequencerExpanderTrig8 : Module {
 	
 	// Expander details
 	int ExpanderID = SequencerExpanderMessage::TRIG8;
-	SequencerExpanderMessage leftMessages[2][1];	// messages from left module (master)
-	SequencerExpanderMessage rightMessages[2][1]; // messages to right module (expander)
-	SequencerExpanderMessage *messagesFromMaster;
+	SequencerExpanderMessage *messagesFromMaster = NULL;
 	
 	int channelID = -1;
 	int prevChannelID = -1;
@@ -69,14 +67,6 @@ struct SequencerExpanderTrig8 : Module {
 	SequencerExpanderTrig8() {
 		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
 		
-		// from left module (master)
-		leftExpander.producerMessage = leftMessages[0];
-		leftExpander.consumerMessage = leftMessages[1];
-		
-		// to right module (expander)
-		rightExpander.producerMessage = rightMessages[0];
-		rightExpander.consumerMessage = rightMessages[1];
-		
 		// step params
 		for (int s = 0; s < SEQ_NUM_STEPS; s++) {
 			configSwitch(STEP_SW_PARAMS + s, 0.0f, 2.0f, 1.0f, "Select Trig/Gate", {"Gate", "Off", "Trigger"});
@@ -130,7 +120,7 @@ struct SequencerExpanderTrig8 : Module {
 		}	
 	}	
 	
-	void process(const ProcessArgs &args) override {
+	void processExpander(const ProcessArgs &args, SequencerExpanderMessage *message) override {
 
 		// details from master
 		bool running = true;
@@ -142,44 +132,42 @@ struct SequencerExpanderTrig8 : Module {
 		
 		colourMap = colourMapDefault;
 		
-		// grab the detail from the left hand module if we have one
+		// grab the detail from the master if we have one
+		messagesFromMaster = message;
 		leftModuleAvailable = false;
-		if (leftExpander.module) {
-			if (isExpanderModule(leftExpander.module) || isExpandableModule(leftExpander.module)) {
-				
-				leftModuleAvailable = true;
-				messagesFromMaster = (SequencerExpanderMessage *)(leftExpander.consumerMessage);
-
-				switch (messagesFromMaster->masterModule) {
-					case SEQUENCER_EXP_MASTER_MODULE_BINARY:
-						colourMap = colourMapBinSeq;
-						break;
-					case SEQUENCER_EXP_MASTER_MODULE_DUALSTEP:
-						colourMap = colourMapSS;
-						break;
-					default:
-						colourMap = colourMapDefault;
-						break;
-				}
-				
-				// grab the channel id for this expander type
-				channelID = clamp(messagesFromMaster->channels[ExpanderID], -1, 3);
-
-				// decode the counter array
-				for(int i = 0; i < SEQUENCER_EXP_MAX_CHANNELS; i++) {
-					channelCounters[i] = messagesFromMaster->counters[i];
-					clockStates[i] = messagesFromMaster->clockStates[i];
-					runningStates[i] = messagesFromMaster->runningStates[i];
+		if (messagesFromMaster) {
 			
-					if (i == channelID) {
-						count = std::max(channelCounters[i], 0);
-						clock = clockStates[i];
-						running = runningStates[i];
-
-						// wrap counters > 8 back around to 1 - for the gated comparator, we'll just treat the shift register like a counter
-						while (count > SEQ_NUM_STEPS)
-							count -= SEQ_NUM_STEPS;
-					}
+			leftModuleAvailable = true;
+
+			switch (messagesFromMaster->masterModule) {
+				case SEQUENCER_EXP_MASTER_MODULE_BINARY:
+					colourMap = colourMapBinSeq;
+					break;
+				case SEQUENCER_EXP_MASTER_MODULE_DUALSTEP:
+					colourMap = colourMapSS;
+					break;
+				default:
+					colourMap = colourMapDefault;
+					break;
+			}
+			
+			// grab the channel id for this expander type
+			channelID = clamp(messagesFromMaster->channels[ExpanderID], -1, 3);
+
+			// decode the counter array
+			for(int i = 0; i < SEQUENCER_EXP_MAX_CHANNELS; i++) {
+				channelCounters[i] = messagesFromMaster->counters[i];
+				clockStates[i] = messagesFromMaster->clockStates[i];
+				runningStates[i] = messagesFromMaster->runningStates[i];
+		
+				if (i == channelID) {
+					count = std::max(channelCounters[i], 0);
+					clock = clockStates[i];
+					running = runningStates[i];
+
+					// wrap counters > 8 back around to 1 - for the gated comparator, we'll just treat the shift register like a counter
+					while (count > SEQ_NUM_STEPS)
+						count -= SEQ_NUM_STEPS;
 				}
 			}
 		}
@@ -258,42 +246,9 @@ struct SequencerExpanderTrig8 : Module {
 		lights[GATE_LIGHT].setBrightness(boolToLight(gate));
 
 	
-		// set up the detail for any secondary expander
-		if (rightExpander.module) {
-			if (isExpanderModule(rightExpander.module)) {
-				
-				SequencerExpanderMessage *messageToExpander = (SequencerExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
-				
-				// set next module's channel number
-				if (channelID < 0) {
-					// we have no left hand module
-					messageToExpander->setDefaultValues();
-				}
-				else {
-					// add the channel counters and gate states
-					for (int i = 0; i < SEQUENCER_EXP_MAX_CHANNELS ; i++) {
-						messageToExpander->counters[i] = channelCounters[i];
-						messageToExpander->clockStates[i] = clockStates[i];
-						messageToExpander->runningStates[i] = runningStates[i];
-					}
-					
-					// pass through the other expander channel numbers and master module details
-					if (messagesFromMaster) {
-						for(int i = 0; i < SequencerExpanderMessage::NUM_EXPANDERS; i++) {
-							if (i != ExpanderID)
-								messageToExpander->setChannel(messagesFromMaster->channels[i], i);
-						}
-
-						messageToExpander->masterModule = messagesFromMaster->masterModule;
-					}
-
-					// set the channel for the next expander of this type
-					messageToExpander->setNextChannel(channelID, ExpanderID);
-				}
-
-				rightExpander.module->leftExpander.messageFlipRequested = true;
-			}
-		}			
+		// set the channel for the next expander of this type
+		if (messagesFromMaster)
+			messagesFromMaster->setNextChannel(channelID, ExpanderID);
 	}
 };
 
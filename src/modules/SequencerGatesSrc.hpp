@@ -2,7 +2,7 @@
 //	/^M^\ Count Modula Plugin for VCV Rack - Standard sequencer trigger/gate expander
 //	Copyright (C) 2020  Adam Verspaget
 //----------------------------------------------------------------------------
-struct STRUCT_NAME : Module {
+struct STRUCT_NAME : ChainedExpander<SequencerChannelMessage> {
 
 	enum ParamIds {
 		NUM_PARAMS
@@ -25,9 +25,7 @@ struct STRUCT_NAME : Module {
 #endif
 	
 	// Expander details
-	SequencerChannelMessage leftMessages[2][1];	// messages from left module (master)
-	SequencerChannelMessage rightMessages[2][1]; // messages to right module (expander)
-	SequencerChannelMessage *messagesFromMaster;
+	SequencerChannelMessage *messagesFromMaster = NULL;
 	
 	// add the variables we'll use when managing themes
 	#include "../themes/variables.hpp"
@@ -46,13 +44,9 @@ struct STRUCT_NAME : Module {
 		// set the theme from the current default value
 		#include "../themes/setDefaultTheme.hpp"
 		
-		// from left module (master)
-		leftExpander.producerMessage = leftMessages[0];
-		leftExpander.consumerMessage = leftMessages[1];		
-		
-		// to right module (expander)
-		rightExpander.producerMessage = rightMessages[0];
-		rightExpander.consumerMessage = rightMessages[1];	
+		// expander chain family
+		isChainExpander = isSequencerChannelExpander;
+		isChainMaster = isSequencerChannelMaster;
 	}
 	
 	json_t *dataToJson() override {
@@ -72,7 +66,7 @@ struct STRUCT_NAME : Module {
 		#include "../themes/dataFromJson.hpp"		
 	}
 
-	void process(const ProcessArgs &args) override {
+	void processExpander(const ProcessArgs &args, SequencerChannelMessage *message) override {
 
 		bool running = false;
 		count = 0;
@@ -80,18 +74,14 @@ struct STRUCT_NAME : Module {
 		clock = false;
 #endif		
 		// grab the detail from the left hand module if we have one
-		messagesFromMaster = 0; 
-		if (leftExpander.module) {
-			if (isExpanderModule(leftExpander.module) || isExpandableModule(leftExpander.module)) {
-					
-				messagesFromMaster = (SequencerChannelMessage *)(leftExpander.consumerMessage);
-
+		messagesFromMaster = message; 
+		if (messagesFromMaster) {
+				
 #if defined TRIGGER_OUTPUTS
-				clock = messagesFromMaster->clockState;
+			clock = messagesFromMaster->clockState;
 #endif
-				count = messagesFromMaster->counter;
-				running = messagesFromMaster->runningState;
-			}
+			count = messagesFromMaster->counter;
+			running = messagesFromMaster->runningState;
 		}
 		
 		// process the step switches, cv and set the length/active step lights etc
@@ -107,26 +97,7 @@ struct STRUCT_NAME : Module {
 			lights[STEP_LIGHTS + c].setBrightness(boolToLight(stepActive));			
 		}
 		
-		// finally set up the details for any secondary expander
-		if (rightExpander.module) {
-			if (isExpanderModule(rightExpander.module)) {
-				
-				SequencerChannelMessage *messageToExpander = (SequencerChannelMessage*)(rightExpander.module->leftExpander.producerMessage);
-				
-				if (messagesFromMaster) {
-					int ch = 0;
-					if (messagesFromMaster->hasMaster)
-						ch = messagesFromMaster->channel;
-						
-					messageToExpander->set(messagesFromMaster->counter, messagesFromMaster->length, messagesFromMaster->clockState, messagesFromMaster->runningState, ch, messagesFromMaster->hasMaster);
-				}
-				else {
-					messageToExpander->initialise();
-				}
-
-				rightExpander.module->leftExpander.messageFlipRequested = true;
-			}
-		}			
+		// the message is passed on to the next expander untouched
 	}
 };
 
@@ -80,7 +80,7 @@ struct STRUCT_NAME : Module {
 		
 	float lengthCVScale = (float)(SEQ_NUM_STEPS - 1);
 	
-	SequencerChannelMessage rightMessages[2][1]; // messages to right module (expander)
+	ExpanderChain<SequencerChannelMessage> expanderChain;	// expanders driven directly from this module
 	
 	// add the variables we'll use when managing themes
 	#include "../themes/variables.hpp"
@@ -126,10 +126,6 @@ struct STRUCT_NAME : Module {
 		
 		// set the theme from the current default value
 		#include "../themes/setDefaultTheme.hpp"
-		
-		// expander
-		rightExpander.producerMessage = rightMessages[0];
-		rightExpander.consumerMessage = rightMessages[1];		
 	}
 	
 	json_t *dataToJson() override {
@@ -275,6 +271,11 @@ struct STRUCT_NAME : Module {
 		lights[ONESHOT_LIGHT].setBrightness(boolToLight(oneShot));
 	}
 	
+	// any change in the layout means the expander chain needs to be resolved again
+	void onExpanderChange(const ExpanderChangeEvent &e) override {
+		expanderChainGeneration()++;
+	}
+	
 	void process(const ProcessArgs &args) override {
 		// grab all the common input values up front
 		float f;
@@ -490,14 +491,13 @@ struct STRUCT_NAME : Module {
 		prevGate = gate;
 		
 		// set up details for the expander
-		if (rightExpander.module) {
-			if (isExpanderModule(rightExpander.module)) {
-				
-				SequencerChannelMessage *messageToExpander = (SequencerChannelMessage*)(rightExpander.module->leftExpander.producerMessage);
-				messageToExpander->set(count, length, clock, running, 1, true);
-				
-				rightExpander.module->leftExpander.messageFlipRequested = true;
-			}
+		if (expanderChain.resolve(this, isSequencerChannelExpander)) {
+			
+			SequencerChannelMessage *messageToExpander = &expanderChain.message;
+			messageToExpander->set(count, length, clock, running, 1, true);
+			
+			// drive the expanders directly so the whole chain sees this sample
+			expanderChain.process(args);
 		}
 	}
 };
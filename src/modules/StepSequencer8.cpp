@@ -88,7 +88,7 @@ struct STRUCT_NAME : Module {
 	int startUpCounter = 0;
 	
 #ifdef SEQUENCER_EXP_MAX_CHANNELS	
-	SequencerExpanderMessage rightMessages[2][1]; // messages to right module (expander)
+	ExpanderChain<SequencerExpanderMessage> expanderChain;	// expanders driven directly from this module
 #endif
 
 	// add the variables we'll use when managing themes
@@ -186,12 +186,6 @@ struct STRUCT_NAME : Module {
 				configOutput(CVI_OUTPUTS + (r * 2) + i, cviOutputLabels[r][i]);
 			}
 		}
-		
-#ifdef SEQUENCER_EXP_MAX_CHANNELS	
-		// expander
-		rightExpander.producerMessage = rightMessages[0];
-		rightExpander.consumerMessage = rightMessages[1];
-#endif	
 
 		// set the theme from the current default value
 		#include "../themes/setDefaultTheme.hpp"
@@ -326,6 +320,13 @@ struct STRUCT_NAME : Module {
 		lights[DIR_LIGHTS + (r * 3) + 2].setBrightness(boolToLight(directionMode[r] == FORWARD)); 	// green
 	}
 	
+#ifdef SEQUENCER_EXP_MAX_CHANNELS
+	// any change in the layout means the expander chain needs to be resolved again
+	void onExpanderChange(const ExpanderChangeEvent &e) override {
+		expanderChainGeneration()++;
+	}
+#endif
+
 	void process(const ProcessArgs &args) override {
 
 		// wait a number of cycles before we use the clock and run inputs to allow them propagate correctly after startup
@@ -577,31 +578,30 @@ struct STRUCT_NAME : Module {
 				
 #ifdef SEQUENCER_EXP_MAX_CHANNELS	
 		// set up details for the expander
-		if (rightExpander.module) {
-			if (isExpanderModule(rightExpander.module)) {
-				
-				SequencerExpanderMessage *messageToExpander = (SequencerExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
+		if (expanderChain.resolve(this, isSequencerExpander)) {
+			
+			SequencerExpanderMessage *messageToExpander = &expanderChain.message;
 
-				// set any potential expander module's channel number
-				messageToExpander->setAllChannels(0);
-	
-				// add the channel counters
-				int j = 0;
-				for (int i = 0; i < SEQUENCER_EXP_MAX_CHANNELS; i++) {
-					messageToExpander->counters[i] = count[j];
-					messageToExpander->clockStates[i] =	gateClock[j].high();
-					messageToExpander->runningStates[i] = running[j];
-						
-					// in case we ever add less than the expected number of rows, wrap them around to fill the expected buffer size
-					if (++j == SEQ_NUM_SEQS)
-						j = 0;
-				}
+			// set any potential expander module's channel number
+			messageToExpander->setAllChannels(0);
+
+			// add the channel counters
+			int j = 0;
+			for (int i = 0; i < SEQUENCER_EXP_MAX_CHANNELS; i++) {
+				messageToExpander->counters[i] = count[j];
+				messageToExpander->clockStates[i] =	gateClock[j].high();
+				messageToExpander->runningStates[i] = running[j];
 					
-				// finally, let all potential expanders know where we came from
-				messageToExpander->masterModule = SEQUENCER_EXP_MASTER_MODULE_DUALSTEP;
-				
-				rightExpander.module->leftExpander.messageFlipRequested = true;
+				// in case we ever add less than the expected number of rows, wrap them around to fill the expected buffer size
+				if (++j == SEQ_NUM_SEQS)
+					j = 0;
 			}
+				
+			// finally, let all potential expanders know where we came from
+			messageToExpander->masterModule = SEQUENCER_EXP_MASTER_MODULE_DUALSTEP;
+			
+			// drive the expanders directly so the whole chain sees this sample
+			expanderChain.process(args);
 		}
 #endif		
 	}
@@ -4,7 +4,7 @@
 //	Copyright (C) 2019  Adam Verspaget
 //----------------------------------------------------------------------------
 #include "../CountModula.hpp"
-#include "../inc/FrequencyDivider.hpp"
+#include "../inc/FrequencyDividerBank.hpp"
 #include "../inc/Utility.hpp"
 
 // set the module name for the theme selection functions
@@ -32,9 +32,17 @@ struct SubHarmonicGenerator : Module {
 	};
 
 	int divisions[5] = {1, 2, 4, 8, 16};
-	FrequencyDivider dividers[5];
+	
+	// one bank per division with one lane per polyphonic channel, all clocked from the same gate processors
+	FrequencyDividerBank<16> dividers[5];
+	GateProcessorSimd gates[4];
+	
+	float mixLevels[5] = {};
+	float outputLevel = 0.0f;
+	int processCount = 8;
 	
 	bool antiAlias = false;
+	bool polyphonic = false;
 
 	// add the variables we'll use when managing themes
 	#include "../themes/variables.hpp"
@@ -55,6 +63,7 @@ struct SubHarmonicGenerator : Module {
 			}
 
 			// dividers
+			dividers[i].setMaxN(16);
 			dividers[i].setN(divisions[i]);
 		}
 
@@ -70,11 +79,17 @@ struct SubHarmonicGenerator : Module {
 		#include "../themes/setDefaultTheme.hpp"
 	}
 	
+	void onReset() override {
+		polyphonic = false;
+		processCount = 8;
+	}
+	
 	json_t *dataToJson() override {
 		json_t *root = json_object();
 
 		json_object_set_new(root, "moduleVersion", json_integer(1));
 		json_object_set_new(root, "antiAlias", json_boolean(antiAlias));
+		json_object_set_new(root, "polyphonic", json_boolean(polyphonic));
 		
 		// add the theme details
 		#include "../themes/dataToJson.hpp"		
@@ -89,34 +104,61 @@ struct SubHarmonicGenerator : Module {
 		if (aa)
 			antiAlias = json_boolean_value(aa);
 		
+		json_t *poly = json_object_get(root, "polyphonic");
+		if (poly)
+			polyphonic = json_boolean_value(poly);
+		
 		// grab the theme details
 		#include "../themes/dataFromJson.hpp"		
 	}	
 
 	void process(const ProcessArgs &args) override {
-		float in = inputs[OSC_INPUT].getVoltage();	
-		float out = 0.0f;
-
-		// assemble the output value from all of the dividers
-		for (int i = 0; i < 5 ; i++) {
-			if (i > 0) {
-				dividers[i].setMaxN(16);
-				float div = (int)(params[DIV_PARAM + i -1].getValue());
-				dividers[i].setN(div);
+		
+		// the divider configuration and levels only need to be updated at control rate
+		if (++processCount > 8) {
+			processCount = 0;
+			
+			for (int i = 0; i < 5 ; i++) {
+				if (i > 0)
+					dividers[i].setN((int)(params[DIV_PARAM + i -1].getValue()));
+			
+				mixLevels[i] = params[MIX_PARAM + i].getValue();
 			}
 			
-			float x = boolToAudio(dividers[i].process(in));
-			float y = params[MIX_PARAM + i].getValue();
-			out += (x * y);
+			outputLevel = params[OUTPUTLEVEL_PARAM].getValue();
 		}
-	
-		// apply the output level amount and set the overload indicator
-		out = out * params[OUTPUTLEVEL_PARAM].getValue();
-		float overloadLevel =  (fabs(out) > 11.2f) ? 1.0f : 0.0f;
-		lights[OVERLOAD_LIGHT].setSmoothBrightness(overloadLevel, args.sampleTime);
+		
+		int channels = polyphonic ? std::max(inputs[OSC_INPUT].getChannels(), 1) : 1;
+		outputs[MIX_OUTPUT].setChannels(channels);
+		
+		int overload = 0;
+		for (int c = 0; c < channels; c += 4) {
+			int g = c >> 2;
+			
+			float_4 in = polyphonic ? inputs[OSC_INPUT].getVoltageSimd<float_4>(c) : float_4(inputs[OSC_INPUT].getVoltage());
+			gates[g].set(in);
+			float_4 edges = gates[g].anyEdge();
+			
+			// assemble the output value from all of the dividers
+			float_4 out = 0.0f;
+			for (int i = 0; i < 5 ; i++) {
+				float_4 x = simd::ifelse(dividers[i].clock(g, edges), 5.0f, -5.0f);
+				out += (x * mixLevels[i]);
+			}
+			
+			// apply the output level amount and set the overload indicator
+			out = out * outputLevel;
+			overload |= simd::movemask(simd::fabs(out) > 11.2f);
 
-		// set the output
-		outputs[MIX_OUTPUT].setVoltage(clamp(out, -11.2f, 11.2f)); // TODO: saturate rather than clip
+			// set the output
+			outputs[MIX_OUTPUT].setVoltageSimd(simd::clamp(out, -11.2f, 11.2f), c); // TODO: saturate rather than clip
+		}
+		
+		// only look at the lanes that are actually in use
+		if (channels < 4)
+			overload &= (1 << channels) - 1;
+		
+		lights[OVERLOAD_LIGHT].setSmoothBrightness(overload ? 1.0f : 0.0f, args.sampleTime);
 	}
 };
 
@@ -158,6 +200,15 @@ struct SubHarmonicGeneratorWidget : ModuleWidget {
 	// include the theme menu item struct we'll when we add the theme menu items
 	#include "../themes/ThemeMenuItem.hpp"	
 	
+	// polyphonic mode menu item
+	struct PolyphonicMenuItem : MenuItem {
+		SubHarmonicGenerator *module;
+	
+		void onAction(const event::Action &e) override {
+			module->polyphonic ^= true;
+		}
+	};
+	
 	void appendContextMenu(Menu *menu) override {
 		SubHarmonicGenerator *module = dynamic_cast<SubHarmonicGenerator*>(this->module);
 		assert(module);
@@ -167,6 +218,14 @@ struct SubHarmonicGeneratorWidget : ModuleWidget {
 		
 		// add the theme menu items
 		#include "../themes/themeMenus.hpp"
+		
+		menu->addChild(new MenuSeparator());
+		menu->addChild(createMenuLabel("Settings"));
+		
+		// add the polyphonic mode menu item
+		PolyphonicMenuItem *polyMenuItem = createMenuItem<PolyphonicMenuItem>("Polyphonic", CHECKMARK(module->polyphonic));
+		polyMenuItem->module = module;
+		menu->addChild(polyMenuItem);
 	}	
 	
 	void step() override {
@@ -5,66 +5,48 @@
 //----------------------------------------------------------------------------
 #include "../CountModula.hpp"
 #include "../inc/Utility.hpp"
-#include "../inc/GateProcessor.hpp"
+#include "../inc/LatchBank.hpp"
 
 // set the module name for the theme selection functions
 #define THEME_MODULE_NAME TFlipFlop
 #define PANEL_FILE "TFlipFlop.svg"
 
-// implements a basic Toggle flip flop
-struct TLatch {
-	GateProcessor T;
-	GateProcessor R;
-	GateProcessor E;
+// implements a basic Toggle flip flop for up to 16 channels
+struct TLatch : LatchBank {
+	GateProcessorSimd T[PORT_MAX_CHANNELS / 4];
+	GateProcessorSimd R[PORT_MAX_CHANNELS / 4];
+	GateProcessorSimd E[PORT_MAX_CHANNELS / 4];
 
-	bool stateQ = false; 
-	bool stateNQ = true;
-	
-	float process (float tIn, float resetIn, float enIn) {
-		T.set(tIn);
-		R.set(resetIn);
-		E.set(enIn);
-
-		if (E.high()) {
-			if (R.high()) {
-				stateQ = false;
-				stateNQ = true;
-			}
-			else if (T.leadingEdge()) {
-				stateQ = !stateQ;
-				stateNQ = !stateNQ;
-			}
+	void process (Input &tIn, Input &resetIn, Input &enIn, int channels) {
+		uint16_t t = 0, r = 0, e = 0;
+		
+		for (int c = 0; c < channels; c += 4) {
+			T[c / 4].set(tIn.getPolyVoltageSimd<float_4>(c));
+			R[c / 4].set(resetIn.getPolyVoltageSimd<float_4>(c));
+			E[c / 4].set(enIn.getNormalPolyVoltageSimd<float_4>(10.0f, c));
+			
+			t |= bits(T[c / 4].leadingEdge(), c);
+			r |= bits(R[c / 4].high(), c);
+			e |= bits(E[c / 4].high(), c);
 		}
+
+		// reset takes priority over the toggle
+		e &= channelBits(channels);
+		uint16_t clear = e & r;
+		uint16_t toggle = e & ~r & t;
 		
-		return boolToGate(stateQ);
+		stateQ = (stateQ & ~clear) ^ toggle;
+		stateNQ = (stateNQ | clear) ^ toggle;
 	}
 	
 	void reset () {
-		T.reset();
-		R.reset();
-		E.reset();
-		stateQ = false; 
-		stateNQ = true;
-	}
-	
-	// gets the current "Q" output
-	float Q() {
-		return boolToGate(stateQ);
-	}
-	
-	// gets the current not Q output
-	float NQ() {
-		return boolToGate(stateNQ);
-	}
-	
-	// gets the current "Q" output light value
-	float QLight() {
-		return boolToLight(stateQ);
-	}
-	
-	// gets the current not Q output light value
-	float NQLight() {
-		return boolToLight(stateNQ);
+		for (int g = 0; g < PORT_MAX_CHANNELS / 4; g++) {
+			T[g].reset();
+			R[g].reset();
+			E[g].reset();
+		}
+		
+		LatchBank::reset();
 	}
 };
 
@@ -90,6 +72,9 @@ struct TFlipFlop : Module {
 
 	TLatch flipflop[2];
 	
+	// polyphonic mode - the flip flops handle as many channels as their inputs provide
+	bool polyphonic = false;
+	
 	// add the variables we'll use when managing themes
 	#include "../themes/variables.hpp"
 		
@@ -112,6 +97,7 @@ struct TFlipFlop : Module {
 	void onReset() override {
 		flipflop[0].reset();
 		flipflop[1].reset();
+		polyphonic = false;
 	}
 
 	json_t *dataToJson() override {
@@ -122,7 +108,7 @@ struct TFlipFlop : Module {
 		// flip flop Q states
 		json_t *QStates = json_array();
 		for (int i = 0; i < 2; i++) {
-			json_array_insert_new(QStates, i, json_boolean(flipflop[i].stateQ));
+			json_array_insert_new(QStates, i, json_boolean(flipflop[i].stateQ & 0x01));
 		}
 		json_object_set_new(root, "QStates", QStates);
 
@@ -130,9 +116,21 @@ struct TFlipFlop : Module {
 		// flip flop NQ states
 		json_t *NQStates = json_array();
 		for (int i = 0; i < 2; i++) {
-			json_array_insert_new(NQStates, i, json_boolean(flipflop[i].stateNQ));
+			json_array_insert_new(NQStates, i, json_boolean(flipflop[i].stateNQ & 0x01));
 		}
 		json_object_set_new(root, "NQStates", NQStates);
+
+		// polyphonic channel states
+		json_t *QBits = json_array();
+		json_t *NQBits = json_array();
+		for (int i = 0; i < 2; i++) {
+			json_array_insert_new(QBits, i, json_integer(flipflop[i].stateQ));
+			json_array_insert_new(NQBits, i, json_integer(flipflop[i].stateNQ));
+		}
+		json_object_set_new(root, "QBits", QBits);
+		json_object_set_new(root, "NQBits", NQBits);
+		
+		json_object_set_new(root, "polyphonic", json_boolean(polyphonic));
 		
 		// add the theme details
 		#include "../themes/dataToJson.hpp"		
@@ -149,7 +147,7 @@ struct TFlipFlop : Module {
 			for (int i = 0; i < 2; i++) {
 				json_t *state = json_array_get(QStates, i);
 				
-				flipflop[i].stateQ = json_is_true(state);
+				flipflop[i].stateQ = (flipflop[i].stateQ & 0xfffe) | (json_is_true(state) ? 0x01 : 0x00);
 			}
 		}
 		
@@ -160,9 +158,25 @@ struct TFlipFlop : Module {
 			for (int i = 0; i < 2; i++) {
 				json_t *state = json_array_get(NQStates, i);
 				
-				flipflop[i].stateNQ = json_is_true(state);
+				flipflop[i].stateNQ = (flipflop[i].stateNQ & 0xfffe) | (json_is_true(state) ? 0x01 : 0x00);
 			}
 		}
+
+		// polyphonic channel states
+		json_t *QBits = json_object_get(root, "QBits");
+		json_t *NQBits = json_object_get(root, "NQBits");
+		
+		for (int i = 0; i < 2; i++) {
+			if (QBits)
+				flipflop[i].stateQ = json_integer_value(json_array_get(QBits, i));
+			
+			if (NQBits)
+				flipflop[i].stateNQ = json_integer_value(json_array_get(NQBits, i));
+		}
+		
+		json_t *poly = json_object_get(root, "polyphonic");
+		if (poly)
+			polyphonic = json_boolean_value(poly);
 		
 		// grab the theme details
 		#include "../themes/dataFromJson.hpp"		
@@ -172,13 +186,21 @@ struct TFlipFlop : Module {
 	void process(const ProcessArgs &args) override {
 		
 		for (int i = 0; i < 2; i++) {
+			// in polyphonic mode each flip flop handles as many channels as there are on its inputs
+			int n = polyphonic ? LatchBank::channels(inputs[T_INPUT + i], inputs[RESET_INPUT + i], inputs[ENABLE_INPUT + i]) : 1;
+			
 			//perform the latch logic with the given inputs
-			flipflop[i].process(inputs[T_INPUT + i].getVoltage(), inputs[RESET_INPUT + i].getVoltage(), inputs[ENABLE_INPUT + i].getNormalVoltage(10.0f));
+			flipflop[i].process(inputs[T_INPUT + i], inputs[RESET_INPUT + i], inputs[ENABLE_INPUT + i], n);
 			
 			// set outputs according to latch states
-			outputs[Q_OUTPUT + i].setVoltage(flipflop[i].Q());
+			outputs[Q_OUTPUT + i].setChannels(n);
+			outputs[NQ_OUTPUT + i].setChannels(n);
+			for (int c = 0; c < n; c += 4) {
+				outputs[Q_OUTPUT + i].setVoltageSimd(flipflop[i].Q(c), c);
+				outputs[NQ_OUTPUT + i].setVoltageSimd(flipflop[i].NQ(c), c);
+			}
+			
 			lights[STATE_LIGHT + i].setSmoothBrightness(flipflop[i].QLight(), args.sampleTime);
-			outputs[NQ_OUTPUT + i].setVoltage(flipflop[i].NQ());
 		}
 	}
 };
@@ -216,6 +238,15 @@ struct TFlipFlopWidget : ModuleWidget {
 	// include the theme menu item struct we'll when we add the theme menu items
 	#include "../themes/ThemeMenuItem.hpp"
 
+	// polyphonic mode menu item
+	struct PolyphonicMenuItem : MenuItem {
+		TFlipFlop *module;
+		
+		void onAction(const event::Action &e) override {
+			module->polyphonic ^= true;
+		}
+	};
+
 	void appendContextMenu(Menu *menu) override {
 		TFlipFlop *module = dynamic_cast<TFlipFlop*>(this->module);
 		assert(module);
@@ -225,6 +256,14 @@ struct TFlipFlopWidget : ModuleWidget {
 		
 		// add the theme menu items
 		#include "../themes/themeMenus.hpp"
+		
+		menu->addChild(new MenuSeparator());
+		menu->addChild(createMenuLabel("Settings"));
+		
+		// add the polyphonic mode menu item
+		PolyphonicMenuItem *polyMenuItem = createMenuItem<PolyphonicMenuItem>("Polyphonic", CHECKMARK(module->polyphonic));
+		polyMenuItem->module = module;
+		menu->addChild(polyMenuItem);
 	}	
 	
 	void step() override {
@@ -266,6 +305,9 @@ struct SingleTFlipFlop : Module {
 
 	TLatch flipflop;
 	
+	// polyphonic mode - the flip flop handles as many channels as its inputs provide
+	bool polyphonic = false;
+	
 	// add the variables we'll use when managing themes
 	#include "../themes/variables.hpp"
 		
@@ -285,6 +327,7 @@ struct SingleTFlipFlop : Module {
 	
 	void onReset() override {
 		flipflop.reset();
+		polyphonic = false;
 	}
 
 	json_t *dataToJson() override {
@@ -293,8 +336,14 @@ struct SingleTFlipFlop : Module {
 		json_object_set_new(root, "moduleVersion", json_integer(1));
 		
 		// flip flop states
-		json_object_set_new(root, "QState", json_boolean(flipflop.stateQ));
-		json_object_set_new(root, "NQState", json_boolean(flipflop.stateNQ));
+		json_object_set_new(root, "QState", json_boolean(flipflop.stateQ & 0x01));
+		json_object_set_new(root, "NQState", json_boolean(flipflop.stateNQ & 0x01));
+
+		// polyphonic channel states
+		json_object_set_new(root, "QBits", json_integer(flipflop.stateQ));
+		json_object_set_new(root, "NQBits", json_integer(flipflop.stateNQ));
+		
+		json_object_set_new(root, "polyphonic", json_boolean(polyphonic));
 
 		// add the theme details
 		#include "../themes/dataToJson.hpp"		
@@ -309,10 +358,24 @@ struct SingleTFlipFlop : Module {
 		json_t *NQState = json_object_get(root, "NQState");
 	
 		if (QState)
-			flipflop.stateQ = json_boolean_value(QState);
+			flipflop.stateQ = (flipflop.stateQ & 0xfffe) | (json_boolean_value(QState) ? 0x01 : 0x00);
 
 		if (NQState)
-			flipflop.stateNQ =  json_boolean_value(NQState);
+			flipflop.stateNQ = (flipflop.stateNQ & 0xfffe) | (json_boolean_value(NQState) ? 0x01 : 0x00);
+
+		// polyphonic channel states
+		json_t *QBits = json_object_get(root, "QBits");
+		json_t *NQBits = json_object_get(root, "NQBits");
+		
+		if (QBits)
+			flipflop.stateQ = json_integer_value(QBits);
+		
+		if (NQBits)
+			flipflop.stateNQ = json_integer_value(NQBits);
+		
+		json_t *poly = json_object_get(root, "polyphonic");
+		if (poly)
+			polyphonic = json_boolean_value(poly);
 		
 		// grab the theme details
 		#include "../themes/dataFromJson.hpp"		
@@ -321,13 +384,21 @@ struct SingleTFlipFlop : Module {
 	
 	void process(const ProcessArgs &args) override {
 
+		// in polyphonic mode the flip flop handles as many channels as there are on its inputs
+		int n = polyphonic ? LatchBank::channels(inputs[T_INPUT], inputs[RESET_INPUT], inputs[ENABLE_INPUT]) : 1;
+		
 		//perform the latch logic
-		flipflop.process(inputs[T_INPUT].getVoltage(), inputs[RESET_INPUT].getVoltage(), inputs[ENABLE_INPUT].getNormalVoltage(10.0f));
+		flipflop.process(inputs[T_INPUT], inputs[RESET_INPUT], inputs[ENABLE_INPUT], n);
 		
 		// set outputs according to latch states
-		outputs[Q_OUTPUT].setVoltage(flipflop.Q());
+		outputs[Q_OUTPUT].setChannels(n);
+		outputs[NQ_OUTPUT].setChannels(n);
+		for (int c = 0; c < n; c += 4) {
+			outputs[Q_OUTPUT].setVoltageSimd(flipflop.Q(c), c);
+			outputs[NQ_OUTPUT].setVoltageSimd(flipflop.NQ(c), c);
+		}
+		
 		lights[Q_LIGHT].setSmoothBrightness(flipflop.QLight(), args.sampleTime);
-		outputs[NQ_OUTPUT].setVoltage(flipflop.NQ());
 		lights[NQ_LIGHT].setSmoothBrightness(flipflop.NQLight(), args.sampleTime);
 	}
 };
@@ -363,6 +434,15 @@ struct SingleTFlipFlopWidget : ModuleWidget {
 	// include the theme menu item struct we'll when we add the theme menu items
 	#include "../themes/ThemeMenuItem.hpp"
 
+	// polyphonic mode menu item
+	struct PolyphonicMenuItem : MenuItem {
+		SingleTFlipFlop *module;
+		
+		void onAction(const event::Action &e) override {
+			module->polyphonic ^= true;
+		}
+	};
+
 	void appendContextMenu(Menu *menu) override {
 		SingleTFlipFlop *module = dynamic_cast<SingleTFlipFlop*>(this->module);
 		assert(module);
@@ -372,6 +452,14 @@ struct SingleTFlipFlopWidget : ModuleWidget {
 		
 		// add the theme menu items
 		#include "../themes/themeMenus.hpp"
+		
+		menu->addChild(new MenuSeparator());
+		menu->addChild(createMenuLabel("Settings"));
+		
+		// add the polyphonic mode menu item
+		PolyphonicMenuItem *polyMenuItem = createMenuItem<PolyphonicMenuItem>("Polyphonic", CHECKMARK(module->polyphonic));
+		polyMenuItem->module = module;
+		menu->addChild(polyMenuItem);
 	}	
 	
 	void step() override {
@@ -50,7 +50,7 @@ struct STRUCT_NAME : Module {
 	int startUpCounter = 0;
 	
 #ifdef SEQUENCER_EXP_MAX_CHANNELS	
-	SequencerExpanderMessage rightMessages[2][1]; // messages to right module (expander)
+	ExpanderChain<SequencerExpanderMessage> expanderChain;	// expanders driven directly from this module
 #endif
 	
 	// add the variables we'll use when managing themes
@@ -91,12 +91,6 @@ struct STRUCT_NAME : Module {
 			}
 		}
 		
-		
-#ifdef SEQUENCER_EXP_MAX_CHANNELS	
-		// expander
-		rightExpander.producerMessage = rightMessages[0];
-		rightExpander.consumerMessage = rightMessages[1];
-#endif			
 
 		// set the theme from the current default value
 		#include "../themes/setDefaultTheme.hpp"
@@ -197,6 +191,13 @@ struct STRUCT_NAME : Module {
 		}
 	}
 
+#ifdef SEQUENCER_EXP_MAX_CHANNELS
+	// any change in the layout means the expander chain needs to be resolved again
+	void onExpanderChange(const ExpanderChangeEvent &e) override {
+		expanderChainGeneration()++;
+	}
+#endif
+
 	void process(const ProcessArgs &args) override {
 
 		// wait a number of cycles before we use the clock and run inputs to allow them propagate correctly after startup
@@ -311,39 +312,38 @@ struct STRUCT_NAME : Module {
 		
 #ifdef SEQUENCER_EXP_MAX_CHANNELS	
 		// set up details for the expander
-		if (rightExpander.module) {
-			if (isExpanderModule(rightExpander.module)) {
-				
-				SequencerExpanderMessage *messageToExpander = (SequencerExpanderMessage*)(rightExpander.module->leftExpander.producerMessage);
-				
-				// set any potential expander module's channel number
-				messageToExpander->setAllChannels(0);
-
-				// standard number of channels = 4
-				int j = 0;
-				for (int i = 0; i < SEQUENCER_EXP_MAX_CHANNELS; i++) {
-					messageToExpander->counters[i] = count[j];
-					messageToExpander->clockStates[i] =	gateClock[j].high();
-					messageToExpander->runningStates[i] = gateRun[j].high();
-					
-					// in case we ever add less than the expected number of rows, wrap them around to fill the expected buffer size
-					if (++j == TRIGSEQ_NUM_ROWS)
-						j = 0;
-				}
+		if (expanderChain.resolve(this, isSequencerExpander)) {
+			
+			SequencerExpanderMessage *messageToExpander = &expanderChain.message;
+			
+			// set any potential expander module's channel number
+			messageToExpander->setAllChannels(0);
+
+			// standard number of channels = 4
+			int j = 0;
+			for (int i = 0; i < SEQUENCER_EXP_MAX_CHANNELS; i++) {
+				messageToExpander->counters[i] = count[j];
+				messageToExpander->clockStates[i] =	gateClock[j].high();
+				messageToExpander->runningStates[i] = gateRun[j].high();
 				
-				// set the gate values for the gate expander
-				for (int i = 0; i < SEQUENCER_EXP_NUM_TRIGGER_OUTS; i++) {
-					messageToExpander->gateStates[i] = gateOutputs[i];
-				}
-	
-				// finally, let all potential expanders know where we came from
-				if (TRIGSEQ_NUM_STEPS == 16)
-					messageToExpander->masterModule = SEQUENCER_EXP_MASTER_MODULE_TRIGGER16;
-				else
-					messageToExpander->masterModule = SEQUENCER_EXP_MASTER_MODULE_TRIGGER8;
-					
-				rightExpander.module->leftExpander.messageFlipRequested = true;
+				// in case we ever add less than the expected number of rows, wrap them around to fill the expected buffer size
+				if (++j == TRIGSEQ_NUM_ROWS)
+					j = 0;
 			}
+			
+			// set the gate values for the gate expander
+			for (int i = 0; i < SEQUENCER_EXP_NUM_TRIGGER_OUTS; i++) {
+				messageToExpander->gateStates[i] = gateOutputs[i];
+			}
+
+			// finally, let all potential expanders know where we came from
+			if (TRIGSEQ_NUM_STEPS == 16)
+				messageToExpander->masterModule = SEQUENCER_EXP_MASTER_MODULE_TRIGGER16;
+			else
+				messageToExpander->masterModule = SEQUENCER_EXP_MASTER_MODULE_TRIGGER8;
+				
+			// drive the expanders directly so the whole chain sees this sample
+			expanderChain.process(args);
 		}		
 #endif		
 	}
@@ -102,8 +102,8 @@ struct VCPolarizer : Module {
 		for (int c = 0; c < n; c++)
 			outputs[CH1_SIGNAL_OUTPUT].setVoltage(polarizer1.process(inputs[CH1_SIGNAL_INPUT].getVoltage(c), manual, cv, cvAmount), c);
 
-		lights[CH1_POS_LIGHT].setSmoothBrightness(polarizer1.positiveLevel, args.sampleTime);
-		lights[CH1_NEG_LIGHT].setSmoothBrightness(polarizer1.negativeLevel, args.sampleTime);
+		lights[CH1_POS_LIGHT].setSmoothBrightness(polarizer1.positiveLevel(), args.sampleTime);
+		lights[CH1_NEG_LIGHT].setSmoothBrightness(polarizer1.negativeLevel(), args.sampleTime);
 		
 		// channel 2
 		manual = params[CH2_MANUAL_PARAM].getValue();
@@ -117,8 +117,8 @@ struct VCPolarizer : Module {
 			outputs[CH2_SIGNAL_OUTPUT].setVoltage(polarizer2.process(inputs[CH2_SIGNAL_INPUT].getVoltage(c), manual, cv, cvAmount), c);
 
 		
-		lights[CH2_POS_LIGHT].setSmoothBrightness(polarizer2.positiveLevel, args.sampleTime);
-		lights[CH2_NEG_LIGHT].setSmoothBrightness(polarizer2.negativeLevel, args.sampleTime);
+		lights[CH2_POS_LIGHT].setSmoothBrightness(polarizer2.positiveLevel(), args.sampleTime);
+		lights[CH2_NEG_LIGHT].setSmoothBrightness(polarizer2.negativeLevel(), args.sampleTime);
 	}
 };
 
@@ -7,27 +7,6 @@
 
 int cTheme = module? module->currentTheme : getDefaultTheme(false);
 
-switch (cTheme) {
-	case 1:	// Moonlight
-		setPanel(APP->window->loadSvg(asset::plugin(pluginInstance, "res/Moonlight/" + panelName)));
-		break;
-	case 2: // Absinthe
-		setPanel(APP->window->loadSvg(asset::plugin(pluginInstance, "res/Absinthe/" + panelName)));
-		break;
-	case 3: // Raven
-		setPanel(APP->window->loadSvg(asset::plugin(pluginInstance, "res/Raven/" + panelName)));
-		break;
-	case 4: // Sanguine
-		setPanel(APP->window->loadSvg(asset::plugin(pluginInstance, "res/Sanguine/" + panelName)));
-		break;
-	case 5: // Blue Moon
-		setPanel(APP->window->loadSvg(asset::plugin(pluginInstance, "res/BlueMoon/" + panelName)));
-		break;
-	case 6: // Trick or Treat
-		setPanel(APP->window->loadSvg(asset::plugin(pluginInstance, "res/TrickOrTreat/" + panelName)));
-		break;
-	default:
-		setPanel(APP->window->loadSvg(asset::plugin(pluginInstance, "res/" + panelName)));
-		break;
-}
+// panels are resolved via the theme panel registry so each one is only loaded once
+setPanel(getThemedPanel(cTheme, panelName));
 	